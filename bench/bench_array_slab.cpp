@@ -0,0 +1,83 @@
+// Multithreaded alloc/free benchmark, lml::array_slab vs malloc / free
+//
+// Each thread repeatedly allocates a burst of arrays, touches them, and
+// frees them, in a different order, so that slots migrate across lists.
+// Usage: bench_array_slab [threads] [iterations]  (build optimized)
+
+#include "c_array_slab.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+constexpr int burst = 256;
+
+template <typename A>
+struct slab_alloc
+{
+  static constexpr char const* name = "array_slab";
+  static A* allocate() { return &lml::array_slab<A>::allocate(); }
+  static void deallocate(A* p) { lml::array_slab<A>::deallocate(*p); }
+};
+
+template <typename A>
+struct malloc_alloc
+{
+  static constexpr char const* name = "malloc";
+  static A* allocate() { return static_cast<A*>(std::malloc(sizeof(A))); }
+  static void deallocate(A* p) { std::free(p); }
+};
+
+template <typename A, template <typename> class Alloc>
+double run(int threads, int iterations)
+{
+  auto work = [iterations] {
+    A* bufs[burst];
+    for (int it = 0; it != iterations; ++it)
+    {
+      for (auto& b : bufs) {
+        b = Alloc<A>::allocate();
+        (*b)[0] = {};
+      }
+      for (int i = 0; i != burst; ++i)
+        Alloc<A>::deallocate(bufs[(i * 7) % burst]);
+    }
+  };
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> pool;
+  for (int t = 0; t != threads; ++t)
+    pool.emplace_back(work);
+  for (auto& t : pool)
+    t.join();
+  std::chrono::duration<double, std::nano> ns
+                                  = std::chrono::steady_clock::now() - start;
+  return ns.count() / (double(threads) * iterations * burst);
+}
+
+template <typename A>
+void compare(char const* type, int threads, int iterations)
+{
+  auto slab = run<A, slab_alloc>(threads, iterations);
+  auto mall = run<A, malloc_alloc>(threads, iterations);
+  std::printf("%-14s %2d threads: %-10s %6.1f ns  %-10s %6.1f ns"
+              "  (x%.2f)\n", type, threads,
+              slab_alloc<A>::name, slab, malloc_alloc<A>::name, mall,
+              mall / slab);
+}
+
+int main(int argc, char** argv)
+{
+  int max_threads = argc > 1 ? std::atoi(argv[1])
+                             : int(std::thread::hardware_concurrency());
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 2000;
+  if (max_threads < 1)
+    max_threads = 1;
+
+  for (int t = 1; t <= max_threads; t *= 2)
+  {
+    compare<float[64]>("float[64]", t, iterations);
+    compare<unsigned char[256]>("uint8_t[256]", t, iterations);
+  }
+}
@@ -0,0 +1,59 @@
+// Large array copy bandwidth, lml::par::assign vs single-threaded assign
+//
+// Copies a 1GiB array (by default) and reports GB/s of array copied,
+// for lml::assign and for lml::par::assign and par::stream_assign
+// limited to 1..N threads.
+// Usage: bench_par_assign [repeats]  (build optimized)
+
+#include "c_array_par.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#ifndef BENCH_PAR_ASSIGN_LOG2_BYTES
+#define BENCH_PAR_ASSIGN_LOG2_BYTES 30
+#endif
+
+using A = std::uint64_t[std::size_t{1} << (BENCH_PAR_ASSIGN_LOG2_BYTES - 3)];
+
+template <typename Copy>
+double gbps(Copy copy, int repeats)
+{
+  copy();  // warm up, fault in pages
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r != repeats; ++r)
+    copy();
+  std::chrono::duration<double> s = std::chrono::steady_clock::now() - start;
+  return double(sizeof(A)) * repeats / s.count() / 1e9;
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = argc > 1 ? std::atoi(argv[1]) : 5;
+  if (repeats < 1)
+    repeats = 1;
+
+  std::unique_ptr<A[]> src{new A[1]}, dst{new A[1]};
+  std::memset(src.get(), 1, sizeof(A));
+  std::memset(dst.get(), 0, sizeof(A));
+  A& s = src[0];
+  A& d = dst[0];
+
+  std::printf("%zu MiB copy\n", sizeof(A) >> 20);
+  std::printf("lml::assign                 : %6.2f GB/s\n",
+              gbps([&] { lml::assign(d) = s; }, repeats));
+
+  auto threads = lml::par::thread_pool::instance().concurrency();
+  for (unsigned t = 1; t <= threads; t = t < threads && 2*t > threads
+                                              ? threads : 2*t)
+  {
+    std::printf("lml::par::assign        %3u: %6.2f GB/s\n", t,
+                gbps([&] { lml::par::assign(d, t) = s; }, repeats));
+    std::printf("lml::par::stream_assign %3u: %6.2f GB/s\n", t,
+                gbps([&] { lml::par::stream_assign(d, t) = s; }, repeats));
+  }
+  return std::memcmp(&d, &s, sizeof(A)) != 0;
+}
@@ -0,0 +1,86 @@
+// Sort benchmark, lml::par::sort and par::sort_rows vs std::sort, and vs
+// std::sort(std::execution::par, ...) when built with a parallel backend
+// (LML_BENCH_STD_PAR defined, e.g. libstdc++ linked with TBB).
+//
+// Sorts 1<<24 random uint64_t by default, and 1<<20 char[16] keys.
+// Usage: bench_par_sort [repeats]  (build optimized)
+
+#include "c_array_par_sort.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+
+#ifdef LML_BENCH_STD_PAR
+#include <execution>
+#endif
+
+#ifndef BENCH_PAR_SORT_LOG2_KEYS
+#define BENCH_PAR_SORT_LOG2_KEYS 24
+#endif
+
+using keys = std::uint64_t[std::size_t{1} << BENCH_PAR_SORT_LOG2_KEYS];
+using names = char[std::size_t{1} << (BENCH_PAR_SORT_LOG2_KEYS - 4)][16];
+
+// ms(a, sort, repeats) mean milliseconds to sort a copy of array a
+template <typename A, typename Sort>
+double ms(A const& a, Sort sort, int repeats)
+{
+  std::unique_ptr<A[]> copy{new A[1]};
+  double total = 0;
+  for (int r = 0; r != repeats; ++r)
+  {
+    std::memcpy(copy.get(), &a, sizeof(A));
+    auto start = std::chrono::steady_clock::now();
+    sort(copy[0]);
+    std::chrono::duration<double, std::milli> t
+                                  = std::chrono::steady_clock::now() - start;
+    total += t.count();
+  }
+  return total / repeats;
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = argc > 1 ? std::atoi(argv[1]) : 3;
+  if (repeats < 1)
+    repeats = 1;
+
+  std::mt19937_64 gen{1};
+  std::unique_ptr<keys[]> k{new keys[1]};
+  for (auto& v : k[0])
+    v = gen();
+  std::unique_ptr<names[]> s{new names[1]};
+  for (auto& name : s[0])
+    for (auto& c : name)
+      c = char('a' + gen() % 26);
+
+  std::printf("%u threads\n", lml::par::thread_pool::instance().concurrency());
+  std::printf("uint64_t[%zu]\n", std::size(k[0]));
+  std::printf("  std::sort       %8.1f ms\n", ms(k[0], [](keys& a) {
+    std::sort(std::begin(a), std::end(a)); }, repeats));
+#ifdef LML_BENCH_STD_PAR
+  std::printf("  std::sort(par)  %8.1f ms\n", ms(k[0], [](keys& a) {
+    std::sort(std::execution::par, std::begin(a), std::end(a)); }, repeats));
+#endif
+  std::printf("  lml::par::sort  %8.1f ms\n", ms(k[0], [](keys& a) {
+    lml::par::sort(a); }, repeats));
+
+  std::printf("char[%zu][16]\n", std::size(s[0]));
+  std::printf("  std::sort (indices, lml::less) %8.1f ms\n",
+              ms(s[0], [](names& a) {
+    std::unique_ptr<std::uint32_t[]> idx{new std::uint32_t[std::size(a)]};
+    for (std::uint32_t i = 0; i != std::size(a); ++i)
+      idx[i] = i;
+    std::sort(idx.get(), idx.get() + std::size(a),
+      [&](std::uint32_t i, std::uint32_t j) {
+        return lml::less{}(a[i], a[j]); });
+  }, repeats));
+  std::printf("  lml::par::sort_rows            %8.1f ms\n",
+              ms(s[0], [](names& a) { lml::par::sort_rows(a); }, repeats));
+}
@@ -0,0 +1,475 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_ALGORITHM_HPP
+#define LML_C_ARRAY_ALGORITHM_HPP
+/*
+  c_array_algorithm.hpp
+  =====================
+
+  Flat fill, find, gather, scatter and permute over C arrays, and
+  reverse, rotate and shift along an axis, constexpr, with runtime paths
+  on the element entry points of c_array_bytes.hpp; the element kernels
+  of c_array_kernels.hpp, if opted in.
+
+  Depends on <bit>, <concepts>, <cstddef>, <cstring>, <limits>, <utility>,
+  "c_array_support.hpp", "c_array_bytes.hpp" and "c_array_bounded.hpp"
+
+  Functions:
+
+    lml::fill(a,v)   assigns v to every element of array a
+    lml::find(a,v)   flat index of the first element of a equal to v,
+                     or flat_size if there's none
+    lml::gather(d,s,idx)     d[i] = s[idx[i]]
+    lml::scatter(d,s,idx)    d[idx[i]] = s[i]
+    lml::permute_inplace(a,p)  a[i] = a[p[i]], in place, by cycles
+    lml::reverse<X>(a)       reverses a along axis X, in place
+    lml::rotate<X>(a,k)      rotates a left by k along axis X, in place
+    lml::shift<X>(a,k,v)     shifts a by k along axis X, in place, filling
+                             the vacated positions with v
+
+  Usage
+  =====
+    int a[4][4];
+    lml::fill(a, 7);
+    assert( lml::find(a, 7) == 0 && lml::find(a, 8) == 16 );
+
+    float col[1000], sorted[1000];
+    int idx[1000];                        // e.g. from a sort by key
+    lml::gather(sorted, col, idx);        // sorted[i] = col[idx[i]]
+    lml::permute_inplace(col, idx);       // the same, in col itself
+
+    unsigned char img[480][640];
+    lml::reverse<0>(img);                 // flip vertically, row swaps
+    lml::reverse<1>(img);                 // flip horizontally
+    lml::shift<0>(img, 8, 0);             // scroll down 8 rows
+
+  Multidimensional arrays are filled and searched as-if flat.
+
+  At runtime, unpadded arrays of scalar elements of 1, 2, 4 or 8 bytes
+  use the element entry points, fill_elements and find_element: the
+  element kernels fill_n and find_n with LML_KERNELS_DISPATCH defined,
+  or out of line when the c_array_kernels library is linked
+  (LML_KERNELS_LIB), where they're multiversioned; otherwise memset,
+  memchr and element loops. find takes that path only for elements
+  with unique object representations (not float) and a value of the
+  element type, so that equality is bytewise. Constant evaluation, and other element
+  types, use elementwise loops.
+
+  Both accept bounded_arrays (c_array_bounded.hpp) of a runtime extent,
+  on the same paths.
+
+  Indices are flat indices, of integral type; the index array has the
+  extents of d for gather, of s for scatter, and of a for permute, while
+  the indexed array may be of any extents. Indices must be in range, and
+  for scatter and permute, distinct (a permutation); not checked.
+  gather of elements of 4 or 8 bytes with 4-byte indices takes
+  gather_elements, the gather kernel if opted in, vectorized at the avx2
+  and avx512 tiers; both prefetch for sources bigger than
+  gather_prefetch_bytes.
+
+  permute_inplace(a,p) follows the cycles of p, moving each element once
+  with one temporary, no second buffer. A mutable p marks the visited
+  positions by complementing its indices, restored before return, O(n).
+  A const p needs no marks; each cycle is moved from its least index,
+  found by walking the cycle first, so it's O(n) times the cycle length.
+
+  Axis X of reverse, rotate and shift counts from 0, the outermost, to
+  rank - 1; along it, the array is a sequence of blocks of contiguous
+  elements (whole rows, for X = 0), in runs over the extents outside X.
+  Blocks are swapped by contiguous element swap loops, for the compiler
+  to vectorize. For the innermost axis, blocks are single elements, which
+  compilers don't vectorize in reverse; at runtime, unpadded arrays of
+  scalar elements of 1, 2, 4 or 8 bytes take reverse_elements instead,
+  the reverse kernel if opted in, by pshufb and vpermq at the avx2 and
+  avx512 tiers.
+  rotate(a,k) is std::rotate of each run, to begin at k; three reversals
+  by swaps, no buffer. shift(a,k,v) moves elements k places up the axis,
+  or down for negative k, like std::shift_right or shift_left; at
+  runtime, for trivially copyable unpadded arrays, each run is moved by
+  one memmove (move_bytes of c_array_bytes.hpp from kernel_min_bytes,
+  the copy kernel if opted in). Zero extents are fine; all three are
+  then no-ops.
+*/
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "c_array_support.hpp"
+#include "c_array_bytes.hpp"
+#include "c_array_bounded.hpp"
+
+#include "namespace.hpp"
+
+namespace impl {
+
+// element_kernel<A> arrays A the element kernels can fill or search
+//
+template <typename A,
+          typename E = remove_all_extents_t<std::remove_reference_t<A>>>
+inline constexpr bool element_kernel = c_array_unpadded<A>
+                                    && std::is_scalar_v<E>
+                                    && ! std::is_volatile_v<E>
+                                    && ! std::is_same_v<std::remove_cv_t<E>,
+                                                        std::nullptr_t>
+                                    && (sizeof(E) == 1 || sizeof(E) == 2
+                                     || sizeof(E) == 4 || sizeof(E) == 8);
+} // impl
+
+// fill(a,v) assigns v to every element of array a
+//
+template <c_array A, typename V,
+          typename E = remove_all_extents_t<A>>
+  requires std::is_assignable_v<E&, V const&>
+constexpr void fill(A& a, V const& v)
+{
+  if constexpr (impl::element_kernel<A>)
+    if (! std::is_constant_evaluated())
+    {
+      using U = impl::uint_bytes<sizeof(E)>;
+      impl::fill_elements(&a, std::bit_cast<U>(static_cast<E>(v)),
+                          flat_size<A>);
+      return;
+    }
+  for (std::size_t i = 0; i != flat_size<A>; ++i)
+    flat_index(a, i) = v;
+}
+
+// find(a,v) flat index of the first element of array a equal to v,
+//           or flat_size<A> if none
+//
+template <c_array A, typename V,
+          typename E = remove_all_extents_t<std::remove_reference_t<A>>>
+  requires requires (E const& e, V const& v) {
+             { e == v } -> std::convertible_to<bool>; }
+constexpr std::size_t find(A const& a, V const& v)
+{
+  if constexpr (impl::element_kernel<A>
+             && std::has_unique_object_representations_v<E>
+             && std::is_same_v<std::remove_cv_t<E>, V>)
+    if (! std::is_constant_evaluated())
+    {
+      using U = impl::uint_bytes<sizeof(E)>;
+      return impl::find_element(&a, std::bit_cast<U>(v), flat_size<A>);
+    }
+  std::size_t i = 0;
+  while (i != flat_size<A> && ! (flat_index(a, i) == v))
+    ++i;
+  return i;
+}
+
+namespace impl {
+
+// gather_kernel<D,S,I> gather(d,s,idx) can take the gather kernel
+//
+template <typename D, typename S, typename I,
+          typename E = remove_all_extents_t<D>>
+inline constexpr bool gather_kernel = element_kernel<D> && element_kernel<S>
+                    && std::is_same_v<E, std::remove_cv_t<
+                                           remove_all_extents_t<S>>>
+                    && (sizeof(E) == 4 || sizeof(E) == 8)
+                    && c_array_unpadded<I>
+                    && sizeof(remove_all_extents_t<I>) == 4
+                    && flat_size<S> <= 0x7fffffff;
+
+} // impl
+
+// Sources of more bytes than this are prefetched by the gather kernel
+inline constexpr std::size_t gather_prefetch_bytes = std::size_t{1} << 20;
+
+// gather(d,s,idx) d[i] = s[idx[i]], flat, for all i; returns d
+//
+template <c_array D, c_array S, c_array I,
+          typename E = remove_all_extents_t<D>,
+          typename ES = remove_all_extents_t<S>,
+          typename EI = remove_all_extents_t<I>>
+  requires same_extents<D, std::remove_cv_t<I>>
+        && std::integral<EI> && std::is_assignable_v<E&, ES const&>
+constexpr D& gather(D& d, S const& s, I const& idx)
+{
+  if constexpr (impl::gather_kernel<D,S,I>)
+    if (! std::is_constant_evaluated())
+    {
+      impl::gather_elements(&d, &s, &idx, flat_size<D>, sizeof(E),
+                            sizeof(S) > gather_prefetch_bytes);
+      return d;
+    }
+  for (std::size_t i = 0; i != flat_size<D>; ++i)
+    flat_index(d, i) = flat_index(s, static_cast<std::size_t>(
+                                       flat_index(idx, i)));
+  return d;
+}
+
+// scatter(d,s,idx) d[idx[i]] = s[i], flat, for all i; returns d
+//
+template <c_array D, c_array S, c_array I,
+          typename E = remove_all_extents_t<D>,
+          typename ES = remove_all_extents_t<S>,
+          typename EI = remove_all_extents_t<I>>
+  requires same_extents<std::remove_cv_t<S>, std::remove_cv_t<I>>
+        && std::integral<EI> && std::is_assignable_v<E&, ES const&>
+constexpr D& scatter(D& d, S const& s, I const& idx)
+{
+  for (std::size_t i = 0; i != flat_size<S>; ++i)
+    flat_index(d, static_cast<std::size_t>(flat_index(idx, i)))
+      = flat_index(s, i);
+  return d;
+}
+
+// permute_inplace(a,p) a[i] = a[p[i]], flat, for all i, in place;
+//                      p is restored after marking visited positions
+//
+template <c_array A, c_array P,
+          typename E = remove_all_extents_t<A>,
+          typename EP = remove_all_extents_t<P>>
+  requires same_extents<A, P> && std::integral<EP>
+        && (! std::is_const_v<EP>) && std::is_move_assignable_v<E>
+        && (flat_size<A> <= std::size_t(std::numeric_limits<
+                             std::make_unsigned_t<EP>>::max() / 2))
+constexpr A& permute_inplace(A& a, P& p)
+{
+  constexpr std::size_t n = flat_size<A>;
+  using U = std::make_unsigned_t<EP>;
+  // visited j when p[j] is complemented, out of range as unsigned
+  auto next = [&](std::size_t j) -> EP& { return flat_index(p, j); };
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    if (static_cast<U>(next(i)) >= n)
+      continue;
+    E t = std::move(flat_index(a, i));
+    std::size_t j = i;
+    for (;;) {
+      auto k = static_cast<std::size_t>(next(j));
+      next(j) = static_cast<EP>(~next(j));
+      if (k == i) {
+        flat_index(a, j) = std::move(t);
+        break;
+      }
+      flat_index(a, j) = std::move(flat_index(a, k));
+      j = k;
+    }
+  }
+  for (std::size_t i = 0; i != n; ++i)
+    next(i) = static_cast<EP>(~next(i));
+  return a;
+}
+
+// permute_inplace(a,p) a[i] = a[p[i]], flat, for all i, in place,
+//                      for const p; each cycle moved from its least index
+//
+template <c_array A, c_array P,
+          typename E = remove_all_extents_t<A>,
+          typename EP = remove_all_extents_t<P>>
+  requires same_extents<A, std::remove_cv_t<P>> && std::integral<EP>
+        && std::is_const_v<EP> && std::is_move_assignable_v<E>
+constexpr A& permute_inplace(A& a, P& p)
+{
+  auto next = [&](std::size_t j) {
+    return static_cast<std::size_t>(flat_index(p, j));
+  };
+  for (std::size_t i = 0; i != flat_size<A>; ++i)
+  {
+    std::size_t j = next(i);
+    while (j > i)
+      j = next(j);
+    if (j != i)
+      continue;
+    E t = std::move(flat_index(a, i));
+    j = i;
+    for (std::size_t k; (k = next(j)) != i; j = k)
+      flat_index(a, j) = std::move(flat_index(a, k));
+    flat_index(a, j) = std::move(t);
+  }
+  return a;
+}
+
+namespace impl {
+
+// axis_dims<A,X> the flat layout of array A along axis X: 'runs' of 'n'
+//                blocks of 'block' contiguous elements
+//
+template <typename A, std::size_t X>
+struct axis_dims
+{
+  using sub = axis_dims<remove_extent_t<A>, X - 1>;
+  static constexpr std::size_t runs = std::extent_v<A> * sub::runs;
+  static constexpr std::size_t n = sub::n;
+  static constexpr std::size_t block = sub::block;
+};
+template <typename A>
+struct axis_dims<A, 0>
+{
+  static constexpr std::size_t runs = 1;
+  static constexpr std::size_t n = std::extent_v<A>;
+  static constexpr std::size_t block = flat_size<remove_extent_t<A>>;
+};
+
+// swap_blocks(a,i,j,m) swaps the m elements from flat index i with j's
+//
+template <typename A>
+constexpr void swap_blocks(A& a, std::size_t i, std::size_t j,
+                           std::size_t m)
+{
+  using std::swap;
+  for (std::size_t k = 0; k != m; ++k)
+    swap(flat_index(a, i + k), flat_index(a, j + k));
+}
+
+// reverse_blocks(a,b,n,m) reverses the order of n blocks of m elements
+//                         from flat index b; single elements of kernel
+//                         arrays by reverse_elements, at runtime
+//
+template <typename A, typename E = remove_all_extents_t<A>>
+constexpr void reverse_blocks(A& a, std::size_t b, std::size_t n,
+                              std::size_t m)
+{
+  if constexpr (element_kernel<A>)
+    if (m == 1 && n > 1 && ! std::is_constant_evaluated())
+    {
+      reverse_elements(&flat_index(a, b), n, sizeof(E));
+      return;
+    }
+  for (std::size_t i = 0, j = n; i + 1 < j; ++i, --j)
+    swap_blocks(a, b + i * m, b + (j - 1) * m, m);
+}
+
+} // impl
+
+// reverse<X>(a) reverses the order of a's elements along axis X
+//
+template <std::size_t X = 0, c_array A,
+          typename E = remove_all_extents_t<A>>
+  requires (X < rank_v<A>) && std::swappable<E>
+constexpr A& reverse(A& a)
+{
+  using D = impl::axis_dims<A, X>;
+  for (std::size_t o = 0; o != D::runs; ++o)
+    impl::reverse_blocks(a, o * D::n * D::block, D::n, D::block);
+  return a;
+}
+
+// rotate<X>(a,k) rotates a along axis X so that index k comes first;
+//                k mod the extent, negative k rotates right
+//
+template <std::size_t X = 0, c_array A,
+          typename E = remove_all_extents_t<A>>
+  requires (X < rank_v<A>) && std::swappable<E>
+constexpr A& rotate(A& a, std::ptrdiff_t k)
+{
+  using D = impl::axis_dims<A, X>;
+  if constexpr (D::n != 0 && D::runs != 0)
+  {
+    constexpr auto n = static_cast<std::ptrdiff_t>(D::n);
+    auto r = static_cast<std::size_t>((k % n + n) % n);
+    if (r == 0)
+      return a;
+    for (std::size_t o = 0; o != D::runs; ++o)
+    {
+      std::size_t b = o * D::n * D::block;
+      impl::reverse_blocks(a, b, r, D::block);
+      impl::reverse_blocks(a, b + r * D::block, D::n - r, D::block);
+      impl::reverse_blocks(a, b, D::n, D::block);
+    }
+  }
+  return a;
+}
+
+// shift<X>(a,k,v) moves a's elements k places up axis X, or down for
+//                 negative k, assigning v to the vacated places
+//
+template <std::size_t X = 0, c_array A, typename V,
+          typename E = remove_all_extents_t<A>>
+  requires (X < rank_v<A>) && std::is_move_assignable_v<E>
+        && std::is_assignable_v<E&, V const&>
+constexpr A& shift(A& a, std::ptrdiff_t k, V const& v)
+{
+  using D = impl::axis_dims<A, X>;
+  constexpr std::size_t m = D::block;
+  constexpr auto n = static_cast<std::ptrdiff_t>(D::n);
+  std::size_t s = static_cast<std::size_t>(k < 0 ? -k : k);
+  std::size_t keep = s < D::n ? D::n - s : 0;
+  for (std::size_t o = 0; o != D::runs && n != 0; ++o)
+  {
+    std::size_t b = o * D::n * m;
+    std::size_t to = b + (k > 0 ? s * m : 0);
+    std::size_t from = b + (k > 0 ? 0 : s * m);
+    bool moved = false;
+    if constexpr (c_array_unpadded<A> && std::is_trivially_copyable_v<E>
+               && std::is_trivially_copy_assignable_v<E>)
+      if (! std::is_constant_evaluated() && keep != 0 && s != 0)
+      {
+        std::size_t bytes = keep * m * sizeof(E);
+        if (bytes >= kernel_min_bytes)
+          impl::move_bytes(&flat_index(a, to), &flat_index(a, from), bytes);
+        else
+          std::memmove(&flat_index(a, to), &flat_index(a, from), bytes);
+        moved = true;
+      }
+    if (! moved && s != 0)
+    {
+      if (k > 0)
+        for (std::size_t i = keep * m; i-- != 0; )
+          flat_index(a, to + i) = std::move(flat_index(a, from + i));
+      else
+        for (std::size_t i = 0; i != keep * m; ++i)
+          flat_index(a, to + i) = std::move(flat_index(a, from + i));
+    }
+    std::size_t f = b + (k > 0 ? 0 : keep * m);
+    for (std::size_t i = 0; i != (D::n - keep) * m; ++i)
+      flat_index(a, f + i) = v;
+  }
+  return a;
+}
+
+// fill(b,v) assigns v to every element of bounded_array b
+//
+template <typename T, typename V,
+          typename E = remove_all_extents_t<T>>
+  requires std::is_assignable_v<E&, V const&>
+constexpr void fill(bounded_array<T> b, V const& v)
+{
+  if constexpr (impl::element_kernel<T[1]>)
+    if (! std::is_constant_evaluated())
+    {
+      using U = impl::uint_bytes<sizeof(E)>;
+      impl::fill_elements(b.data(), std::bit_cast<U>(static_cast<E>(v)),
+                          b.flat_count());
+      return;
+    }
+  for (std::size_t i = 0; i != b.flat_count(); ++i)
+    b.flat(i) = v;
+}
+
+// find(b,v) flat index of the first element of bounded_array b equal
+//           to v, or b.flat_count() if none
+//
+template <typename T, typename V,
+          typename E = remove_all_extents_t<T>>
+  requires requires (E const& e, V const& v) {
+             { e == v } -> std::convertible_to<bool>; }
+constexpr std::size_t find(bounded_array<T> b, V const& v)
+{
+  if constexpr (impl::element_kernel<T[1]>
+             && std::has_unique_object_representations_v<E>
+             && std::is_same_v<std::remove_cv_t<E>, V>)
+    if (! std::is_constant_evaluated())
+    {
+      using U = impl::uint_bytes<sizeof(E)>;
+      return impl::find_element(b.data(), std::bit_cast<U>(v),
+                                b.flat_count());
+    }
+  std::size_t i = 0;
+  while (i != b.flat_count() && ! (b.flat(i) == v))
+    ++i;
+  return i;
+}
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_ALGORITHM_HPP
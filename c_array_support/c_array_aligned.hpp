@@ -0,0 +1,179 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_ALIGNED_HPP
+#define LML_C_ARRAY_ALIGNED_HPP
+/*
+  c_array_aligned.hpp
+  ===================
+
+  Over-aligned C arrays, with their alignment in the type, so that
+  loops over them can skip alignment prologues.
+
+  Depends on <bit>, <memory>, "c_array_support.hpp"
+  and "c_array_compare.hpp"
+
+  Traits and concepts:
+
+    lml::array_alignment_v<A>    the alignment guaranteed by type A
+    lml::c_array_aligned<A,Al>   array type A is at least Al aligned
+
+  Class template:
+
+    lml::aligned_array<T,Align,I...>  alignas(Align) aggregate holding
+                                      a C array T[I]..., member data
+
+  Aliases:
+
+    lml::array<T,I...>     aligned_array of T's own alignment
+    lml::array_of_t<A>     lml::array holding a C array of type A
+
+  Functions:
+
+    lml::assume_aligned_flat(a)  flat_cast(a) via std::assume_aligned
+
+  Usage
+  =====
+    lml::aligned_array<float,64,1024> a{}, b{};
+    a[3] = 1.f;
+    b = a;                        // aligned vector copy
+    assert( a == b );             // lml::equal_to, on aligned arrays
+
+    float (&f)[1024] = lml::assume_aligned_flat(a);
+    for (auto& e : f)             // no alignment peeling needed
+      e *= 2;
+
+    alignas(32) int raw[4][8];    // alignas on a variable isn't typed,
+    auto& r = lml::assume_aligned_flat<32>(raw); // so state it
+
+  The alignment of a plain C array type is that of its element, as
+  alignas can't apply to an array type, only to a variable or member
+  declaration, which the type doesn't record. aligned_array records it;
+  it's an aggregate wrapping the array, which converts to a reference
+  to the array, with a subscript, and with == and <=> by the lml::
+  functors on assume_aligned_flat arrays, so they take the bytewise
+  kernel or an aligned elementwise loop. Copy is the implicit struct
+  copy, which compilers do with aligned moves.
+
+  c_array_aligned<A,Align> matches C arrays whose element alignment is
+  at least Align, and aligned_arrays of at least Align. simd_load,
+  simd_store and simd_view of c_array_simd.hpp use aligned loads and
+  stores for aligned_arrays.
+
+  assume_aligned_flat<Align>(a) returns a's flattened array, annotated
+  with std::assume_aligned<Align>; Align defaults to the guaranteed
+  alignment of the type. It is undefined behavior if a is less aligned.
+*/
+
+#include <bit>
+#include <memory>
+
+#include "c_array_support.hpp"
+#include "c_array_compare.hpp"
+
+#include "namespace.hpp"
+
+// aligned_array<T,Align,I...> an alignas(Align) aggregate array T[I]...
+//
+template <typename T, std::size_t Align, int... I>
+  requires (sizeof...(I) != 0 && std::has_single_bit(Align)
+                              && Align >= alignof(T))
+struct alignas(Align) aligned_array
+{
+  using array_type = c_array_t<T, I...>;
+
+  static constexpr std::size_t alignment = Align;
+
+  array_type data;
+
+  constexpr auto& operator[](std::size_t i) noexcept { return data[i]; }
+  constexpr auto& operator[](std::size_t i) const noexcept
+  {
+    return data[i];
+  }
+
+  constexpr operator array_type&() & noexcept { return data; }
+  constexpr operator array_type const&() const& noexcept { return data; }
+
+  friend constexpr bool operator==(aligned_array const& l,
+                                   aligned_array const& r)
+    requires equality_comparable<array_type>
+  {
+    return equal_to{}(assume_aligned_flat(l), assume_aligned_flat(r));
+  }
+
+  friend constexpr auto operator<=>(aligned_array const& l,
+                                    aligned_array const& r)
+    requires three_way_comparable<array_type>
+  {
+    return compare_three_way{}(assume_aligned_flat(l),
+                               assume_aligned_flat(r));
+  }
+};
+
+// array<T,I...> aligned_array of natural alignment; an array value type
+//
+template <typename T, int... I>
+using array = aligned_array<T, alignof(T), I...>;
+
+namespace impl {
+template <typename A, int... I>
+struct array_of { using type = array<A, I...>; };
+template <typename T, std::size_t N, int... I>
+struct array_of<T[N], I...> : array_of<T, I..., int(N)> {};
+} // impl
+
+// array_of_t<A> the lml::array type holding a C array of type A
+//               e.g. array_of_t<int[2][3]> -> array<int,2,3>
+//
+template <c_array A>
+using array_of_t = typename impl::array_of<std::remove_cvref_t<A>>::type;
+
+namespace impl {
+template <typename>
+inline constexpr bool is_aligned_array = false;
+template <typename T, std::size_t Align, int... I>
+inline constexpr bool is_aligned_array<aligned_array<T,Align,I...>>
+                                                                  = true;
+} // impl
+
+// aligned_array_type<A> concept: A is an aligned_array, under cvref
+//
+template <typename A>
+concept aligned_array_type = impl::is_aligned_array<std::remove_cvref_t<A>>;
+
+// array_alignment_v<A> the alignment guaranteed by array type A
+//
+template <typename A>
+inline constexpr std::size_t array_alignment_v
+                           = alignof(std::remove_cvref_t<A>);
+
+// c_array_aligned<A,Align> concept: A is a C array or aligned_array
+//                                   that's at least Align aligned
+//
+template <typename A, std::size_t Align>
+concept c_array_aligned = (c_array<A> || aligned_array_type<A>)
+                       && array_alignment_v<A> >= Align;
+
+// assume_aligned_flat<Align>(a) flat_cast(a), assumed Align aligned,
+//  of a C array or of the data of an aligned_array
+//
+template <std::size_t Align = 0, typename A>
+  requires (c_array_unpadded<A&> || aligned_array_type<A>)
+constexpr auto& assume_aligned_flat(A& a) noexcept
+{
+  if constexpr (aligned_array_type<A>)
+    return assume_aligned_flat<Align ? Align : A::alignment>(a.data);
+  else
+  {
+    constexpr std::size_t align = Align ? Align : array_alignment_v<A>;
+    static_assert( std::has_single_bit(align) );
+    return *std::assume_aligned<align>(&flat_cast(a));
+  }
+}
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_ALIGNED_HPP
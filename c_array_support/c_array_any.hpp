@@ -0,0 +1,381 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_ANY_HPP
+#define LML_C_ARRAY_ANY_HPP
+/*
+  c_array_any.hpp
+  ===============
+
+  Type-erased references to C arrays of scalars, with their shape held
+  at runtime, and non-template kernels over them; one copy of the code
+  serves all array types.
+
+  Depends on <compare>, <cstdint>, <cstring>, <utility>,
+  "c_array_support.hpp", "c_array_kernels.hpp" and "c_array_hash.hpp"
+
+  Types:
+
+    lml::element_kind          signed_int, unsigned_int, floating, pointer
+    lml::element_type          {kind, size} descriptor of an element type
+    lml::any_array_cref        reference to a const array of any shape
+    lml::any_array_ref         reference to a mutable array of any shape
+
+  Traits and concepts:
+
+    lml::any_element<E>        E is a type any_array refs can refer to
+    lml::element_type_of<E>    the element_type descriptor of E
+
+  Functions, non-template:
+
+    lml::any_copy(d,s)       copies array s to d, if the same shape
+    lml::any_equal(l,r)      true if the same shape and equal elements
+    lml::any_compare(l,r)    lexicographic partial_ordering
+    lml::any_hash(a)         lml::hash{}(a) of the referenced array
+    lml::any_fill(d,v)       stores the element at v in each of d
+    lml::same_shape(l,r)     same element type, rank and extents
+
+  Usage
+  =====
+    // One out-of-line function for all array types
+    bool plugin_equal(lml::any_array_cref l, lml::any_array_cref r) {
+      return lml::any_equal(l, r);
+    }
+    int a[2][3]{}, b[2][3]{};
+    assert( plugin_equal(a, b) );
+
+    lml::any_array_ref d = a;             // implicit, from any C array
+    assert( d.rank() == 2 && d.extent(1) == 3 && d.size() == 6 );
+    int seven = 7;
+    lml::any_fill(d, &seven);
+
+  Each distinct array type instantiates its own lml::assign, equal_to
+  and hash code; any_array refs trade that for a runtime dispatch on the
+  element_type, so code that handles many array types, or crosses an
+  ABI boundary, can share one instantiation. Constructing a ref is a
+  pointer, a size and a pointer to static extents, per array type.
+
+  Elements are scalars of 1, 2, 4 or 8 bytes: integers, enums, float,
+  double and object pointers (not member pointers or nullptr_t). Arrays
+  must be unpadded. Floating point elements compare and hash as values,
+  as lml::equal_to and lml::hash do; others as bytes, by the kernels of
+  c_array_kernels.hpp. any_compare orders integers by value, pointers
+  by address, and returns unordered for arrays of different shape, or
+  if an element is NaN.
+
+  The kernels are inline unless LML_KERNELS_LIB is defined, in which
+  case they're compiled once, in the c_array_kernels library.
+*/
+
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "c_array_support.hpp"
+#include "c_array_kernels.hpp"
+#include "c_array_hash.hpp"
+
+// LML_KERNEL as in c_array_kernels.hpp; out of line in the library
+//
+#if ! defined(LML_KERNELS_LIB)
+#define LML_KERNEL inline
+#define LML_KERNEL_DEFINE
+#elif defined(LML_KERNELS_SOURCE)
+#define LML_KERNEL
+#define LML_KERNEL_DEFINE
+#else
+#define LML_KERNEL
+#endif
+
+#include "namespace.hpp"
+
+enum class element_kind : std::uint8_t
+{
+  signed_int, unsigned_int, floating, pointer
+};
+
+// element_type descriptor; element kind and byte size
+//
+struct element_type
+{
+  element_kind kind;
+  std::uint8_t size;
+
+  friend constexpr bool operator==(element_type, element_type) = default;
+};
+
+// any_element<E> concept: E is a scalar that any_array refs can refer to
+//
+template <typename E>
+concept any_element = (std::is_integral_v<E> || std::is_enum_v<E>
+                    || std::is_pointer_v<E>
+                    || std::is_same_v<std::remove_cv_t<E>, float>
+                    || std::is_same_v<std::remove_cv_t<E>, double>)
+                    && ! std::is_volatile_v<E>
+                    && (sizeof(E) == 1 || sizeof(E) == 2
+                     || sizeof(E) == 4 || sizeof(E) == 8);
+
+namespace impl {
+
+template <typename E>
+constexpr element_kind kind_of() noexcept
+{
+  if constexpr (std::is_pointer_v<E>)
+    return element_kind::pointer;
+  else if constexpr (std::is_floating_point_v<E>)
+    return element_kind::floating;
+  else if constexpr (std::is_enum_v<E>)
+    return kind_of<std::underlying_type_t<E>>();
+  else if constexpr (std::is_signed_v<E>)
+    return element_kind::signed_int;
+  else
+    return element_kind::unsigned_int;
+}
+
+// extents_of<A>::value the extents of array type A, as static data
+//
+template <typename A, typename = std::make_index_sequence<std::rank_v<A>>>
+struct extents_of;
+
+template <typename A, std::size_t... I>
+struct extents_of<A, std::index_sequence<I...>>
+{
+  static constexpr std::size_t value[] = {std::extent_v<A, I>...};
+};
+
+} // impl
+
+// element_type_of<E> the element_type descriptor of any_element E
+//
+template <any_element E>
+inline constexpr element_type element_type_of
+  = {impl::kind_of<std::remove_cv_t<E>>(), sizeof(E)};
+
+// any_array_cref a reference to a const C array of any_element type,
+//  of any shape; data pointer, element_type, rank and extents
+//
+class any_array_cref
+{
+ public:
+  template <c_array A,
+            typename E = remove_all_extents_t<std::remove_reference_t<A>>>
+    requires c_array_unpadded<A const&> && any_element<E>
+  constexpr any_array_cref(A const& a) noexcept
+    : data_{&a}, size_{flat_size<A>},
+      extents_{impl::extents_of<std::remove_cvref_t<A>>::value},
+      element_{element_type_of<E>},
+      rank_{static_cast<std::uint8_t>(std::rank_v<std::remove_cvref_t<A>>)}
+  {}
+
+  constexpr void const* data() const noexcept { return data_; }
+  constexpr element_type element() const noexcept { return element_; }
+  constexpr std::size_t rank() const noexcept { return rank_; }
+
+  // extent(i) the i'th extent, i < rank()
+  constexpr std::size_t extent(std::size_t i) const noexcept
+  {
+    return extents_[i];
+  }
+  constexpr std::size_t const* extents() const noexcept { return extents_; }
+
+  // size() the flat number of elements
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr std::size_t size_bytes() const noexcept
+  {
+    return size_ * element_.size;
+  }
+
+ private:
+  void const* data_;
+  std::size_t size_;
+  std::size_t const* extents_;
+  element_type element_;
+  std::uint8_t rank_;
+};
+
+// any_array_ref a reference to a mutable C array of any_element type;
+//  converts to any_array_cref
+//
+class any_array_ref : public any_array_cref
+{
+ public:
+  template <c_array A,
+            typename E = remove_all_extents_t<std::remove_reference_t<A>>>
+    requires c_array_unpadded<A&> && any_element<E>
+          && (! std::is_const_v<E>)
+  constexpr any_array_ref(A& a) noexcept : any_array_cref{a} {}
+
+  void* data() const noexcept
+  {
+    return const_cast<void*>(any_array_cref::data());
+  }
+};
+
+// same_shape(l,r) true if l and r have the same element type and extents
+//
+constexpr bool same_shape(any_array_cref l, any_array_cref r) noexcept
+{
+  if (l.element() != r.element() || l.rank() != r.rank())
+    return false;
+  for (std::size_t i = 0; i != l.rank(); ++i)
+    if (l.extent(i) != r.extent(i))
+      return false;
+  return true;
+}
+
+// any_copy(d,s) copies array s to d, if of the same shape, else false
+//
+LML_KERNEL bool any_copy(any_array_ref d, any_array_cref s) noexcept;
+
+// any_equal(l,r) true if l and r have the same shape and equal elements
+//
+LML_KERNEL bool any_equal(any_array_cref l, any_array_cref r) noexcept;
+
+// any_compare(l,r) lexicographic comparison of l and r, if the same shape,
+//                  else unordered
+//
+LML_KERNEL std::partial_ordering any_compare(any_array_cref l,
+                                             any_array_cref r) noexcept;
+
+// any_hash(a) lml::hash{}(a) of the array referenced by a
+//
+LML_KERNEL std::size_t any_hash(any_array_cref a) noexcept;
+
+// any_fill(d,v) stores the element at v, of d's element type, in all of d
+//
+LML_KERNEL void any_fill(any_array_ref d, void const* v) noexcept;
+
+#if defined(LML_KERNEL_DEFINE)
+
+namespace impl {
+
+// load_as<U>(p,i) the i'th element of type U at p
+//
+template <typename U>
+inline U load_as(void const* p, std::size_t i) noexcept
+{
+  U u;
+  std::memcpy(&u, static_cast<unsigned char const*>(p) + i * sizeof(U),
+              sizeof(U));
+  return u;
+}
+
+// any_mismatch(l,r) index of the first differing element, by bytes
+//
+inline std::size_t any_mismatch(any_array_cref l, any_array_cref r)
+  noexcept
+{
+  auto n = l.size_bytes();
+  auto m = n >= kernel_min_bytes ? kernels().mismatch(l.data(), r.data(), n)
+                                 : mismatch_scalar(l.data(), r.data(), n);
+  return m / l.element().size;
+}
+
+template <typename F>
+inline std::partial_ordering compare_floats(any_array_cref l,
+                                            any_array_cref r) noexcept
+{
+  for (std::size_t i = 0; i != l.size(); ++i)
+    if (auto c = load_as<F>(l.data(), i) <=> load_as<F>(r.data(), i);
+        c != 0)
+      return c;
+  return std::partial_ordering::equivalent;
+}
+
+template <typename F>
+inline std::size_t hash_floats(any_array_cref a) noexcept
+{
+  std::uint64_t h = a.size() * hash_k;
+  for (std::size_t i = 0; i != a.size(); ++i)
+    h = hash_word(h, float_bits(load_as<F>(a.data(), i)));
+  return hash_fmix(h);
+}
+
+template <typename I>
+inline std::partial_ordering compare_at(any_array_cref l,
+                                        any_array_cref r,
+                                        std::size_t i) noexcept
+{
+  return load_as<I>(l.data(), i) <=> load_as<I>(r.data(), i);
+}
+
+} // impl
+
+LML_KERNEL bool any_copy(any_array_ref d, any_array_cref s) noexcept
+{
+  if (! same_shape(d, s))
+    return false;
+  auto n = d.size_bytes();
+  if (n >= kernel_min_bytes)
+    kernels().copy(d.data(), s.data(), n);
+  else if (n != 0)
+    std::memmove(d.data(), s.data(), n);
+  return true;
+}
+
+LML_KERNEL bool any_equal(any_array_cref l, any_array_cref r) noexcept
+{
+  return any_compare(l, r) == 0;
+}
+
+LML_KERNEL std::partial_ordering any_compare(any_array_cref l,
+                                             any_array_cref r) noexcept
+{
+  if (! same_shape(l, r))
+    return std::partial_ordering::unordered;
+  auto size = l.element().size;
+  if (l.element().kind == element_kind::floating)
+    return size == 4 ? impl::compare_floats<float>(l, r)
+                     : impl::compare_floats<double>(l, r);
+  auto i = impl::any_mismatch(l, r);
+  if (i == l.size())
+    return std::partial_ordering::equivalent;
+  if (l.element().kind == element_kind::signed_int)
+    switch (size) {
+      case 1: return impl::compare_at<std::int8_t>(l, r, i);
+      case 2: return impl::compare_at<std::int16_t>(l, r, i);
+      case 4: return impl::compare_at<std::int32_t>(l, r, i);
+      default: return impl::compare_at<std::int64_t>(l, r, i);
+    }
+  switch (size) {
+    case 1: return impl::compare_at<std::uint8_t>(l, r, i);
+    case 2: return impl::compare_at<std::uint16_t>(l, r, i);
+    case 4: return impl::compare_at<std::uint32_t>(l, r, i);
+    default: return impl::compare_at<std::uint64_t>(l, r, i);
+  }
+}
+
+LML_KERNEL std::size_t any_hash(any_array_cref a) noexcept
+{
+  if (a.element().kind == element_kind::floating)
+    return a.element().size == 4 ? impl::hash_floats<float>(a)
+                                 : impl::hash_floats<double>(a);
+  return impl::hash_bytes(static_cast<unsigned char const*>(a.data()),
+                          a.size_bytes());
+}
+
+LML_KERNEL void any_fill(any_array_ref d, void const* v) noexcept
+{
+  switch (d.element().size) {
+    case 1: impl::fill_n(d.data(), impl::load_as<std::uint8_t>(v, 0),
+                         d.size()); break;
+    case 2: impl::fill_n(d.data(), impl::load_as<std::uint16_t>(v, 0),
+                         d.size()); break;
+    case 4: impl::fill_n(d.data(), impl::load_as<std::uint32_t>(v, 0),
+                         d.size()); break;
+    default: impl::fill_n(d.data(), impl::load_as<std::uint64_t>(v, 0),
+                          d.size()); break;
+  }
+}
+
+#endif // LML_KERNEL_DEFINE
+
+#include "namespace.hpp"
+
+#undef LML_KERNEL
+#undef LML_KERNEL_DEFINE
+
+#endif // LML_C_ARRAY_ANY_HPP
@@ -9,14 +9,16 @@
   c_array_assign.hpp
   ==================
 
-  Requires C++20 and depends on <concepts> and "c_array_support.hpp".
+  Requires C++20 and depends on <concepts>, <cstring>, <iterator>,
+  <stdexcept>, <tuple>, "c_array_support.hpp" and "c_array_bytes.hpp".
 
   This header defines 'assign(l)', generic assignment function, and its
   customization point 'assign_to', with C array specialization, plus a
   generic elementwise 'assign_elements(l,e...)' function:
 
    * assign(l) = r; a uniform assignment syntax for lvalue variables
-   * assign_to<T[N]> an assignable reference-wrapper for array variables
+   * assign_to<T[N]> an assignable reference-wrapper for array variables,
+                     assignable from arrays, braced lists and sized ranges
    * assign_elements(l,e...) assigns elements directly by move or copy
 
   Traits and concepts for assign() are defined as versions of std traits
@@ -63,6 +65,7 @@
     lml::assign(l) = r
     lml::assign(l) = {}
     lml::assign(l) = {1,2}
+    lml::assign(l) = vec          // a std::vector of flat_size<L> elements
     lml::assign_elements(l,4,2)
 
   An lvalue reference to l is returned, as for regular assignment l = r.
@@ -81,15 +84,41 @@
   A specialization of assign_to is provided for lml::tupl along with an
   overload of assign_elements.
 
+  Sized ranges, such as std::vector, std::span or std::array, and ranges
+  of them nested (std::array<std::array<int,3>,2>), are assigned in
+  flattened order. Their flat element count must equal flat_size<L>;
+  checked by static_assert for sources of static extent throughout
+  (std::array, fixed-extent std::span, C arrays) else at runtime, with
+  std::length_error thrown on mismatch.
+
+  A specialization of assign_to is provided for lml::bounded_array, of
+  runtime extent, assigned from a bounded_array or C array of the same
+  extent (a precondition, not checked), on the same bulk copy path with
+  a runtime byte count (include c_array_bounded.hpp to use it).
+
   Performance
   ===========
-  Copy optimizations such as memcpy specializations are not done, yet.
   Nested array copies have both constexpr and runtime implementations.
+  At runtime, copies between unpadded arrays of the same trivially
+  copyable element type are done by a single memmove of all the bytes
+  (the bulk_copyable<L,R> trait), by copy_bytes_n<sizeof l> of
+  c_array_bytes.hpp, shared by all arrays of the same byte size; the
+  dispatched copy kernel for kernel_min_bytes or more, if opted in.
+  Otherwise elementwise.
+  Contiguous ranges of the same trivially copyable element type, or of
+  unpadded static-extent ranges of it, are copied by memcpy; other
+  ranges are streamed element by element.
+  See c_array_par.hpp for par::assign, a multithreaded bulk copy.
 */
 
 #include <concepts>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
 
 #include "c_array_support.hpp"
+#include "c_array_bytes.hpp"
 
 #include "namespace.hpp"
 
@@ -243,6 +272,142 @@ template <typename T>
 using is_nothrow_empty_list_assignable = std::bool_constant<
          noexcept(std::declval<all_extents_removed_t<T>&>() = {})>;
 
+// bulk_copyable<L,R> true if array R can be copied to array L as bytes;
+//  both unpadded arrays of the same trivially copyable element type
+//
+template <typename L, typename R,
+          typename EL = remove_all_extents_t<std::remove_reference_t<L>>,
+          typename ER = remove_all_extents_t<std::remove_reference_t<R>>>
+inline constexpr bool bulk_copyable = c_array_unpadded<L>
+                                   && c_array_unpadded<R>
+                                   && same_extents<std::remove_cvref_t<L>,
+                                                   std::remove_cvref_t<R>>
+                                   && std::is_same_v<EL, std::remove_cv_t<ER>>
+                                   && ! std::is_volatile_v<ER>
+                                   && std::is_trivially_copyable_v<EL>
+                                   && std::is_trivially_copy_assignable_v<EL>;
+
+namespace impl {
+
+// range_ref_t<R> the reference type of sized range R, or void
+//
+template <typename R>
+struct range_ref { using type = void; };
+template <typename R>
+  requires requires (R& r) { std::ranges::begin(r);
+                             std::ranges::end(r);
+                             std::ranges::size(r); }
+struct range_ref<R> {
+  using type = std::iter_reference_t<
+                 decltype(std::ranges::begin(std::declval<R&>()))>;
+};
+template <typename R>
+using range_ref_t = typename range_ref<R>::type;
+
+// range_depth<E,R>() nesting depth of sized range R of elements that
+//                    are assignable to E, or 0 if none
+//
+template <typename E, typename R>
+consteval int range_depth()
+{
+  using V = range_ref_t<R>;
+  if constexpr (std::is_void_v<V>)
+    return 0;
+  else if constexpr (std::is_assignable_v<E&, V>)
+    return 1;
+  else {
+    constexpr int d = range_depth<E, V>();
+    return d == 0 ? 0 : d + 1;
+  }
+}
+
+inline constexpr std::size_t dynamic_size = std::size_t(-1);
+
+// static_range_size<R> the extent of R if static, else dynamic_size
+//
+template <typename R, typename T = std::remove_cvref_t<R>>
+inline constexpr std::size_t static_range_size = dynamic_size;
+template <typename R, typename T>
+  requires std::is_bounded_array_v<T>
+inline constexpr std::size_t static_range_size<R,T> = std::extent_v<T>;
+template <typename R, typename T>
+  requires requires { std::tuple_size<T>::value; }
+inline constexpr std::size_t static_range_size<R,T> = std::tuple_size<T>::value;
+template <typename R, typename T>
+  requires requires { std::integral_constant<std::size_t, T::extent>{}; }
+inline constexpr std::size_t static_range_size<R,T> = T::extent;
+
+// static_flat_size<E,R>() the flat element count of range R, nested to
+//                         elements E, if static throughout
+//
+template <typename E, typename R>
+consteval std::size_t static_flat_size()
+{
+  constexpr std::size_t n = static_range_size<R>;
+  if constexpr (n == dynamic_size || range_depth<E,R>() == 1)
+    return n;
+  else {
+    constexpr std::size_t m = static_flat_size<E, range_ref_t<R>>();
+    return m == dynamic_size ? m : n * m;
+  }
+}
+
+// range_flat_size<E>(r) the flat element count of range r
+//
+template <typename E, typename R>
+constexpr std::size_t range_flat_size(R&& r)
+{
+  if constexpr (static_flat_size<E,R>() != dynamic_size)
+    return static_flat_size<E,R>();
+  else if constexpr (range_depth<E,R>() == 1)
+    return static_cast<std::size_t>(std::ranges::size(r));
+  else {
+    std::size_t n = 0;
+    for (auto&& e : r)
+      n += range_flat_size<E>(e);
+    return n;
+  }
+}
+
+// bulk_range<E,R>() true if contiguous range R holds the bytes of
+//                   its flat elements, all of type E, unpadded
+//
+template <typename E, typename R>
+consteval bool bulk_range()
+{
+  using V = std::remove_reference_t<range_ref_t<R>>;
+  if constexpr (! requires (R& r) { std::ranges::data(r); }
+             || ! std::contiguous_iterator<
+                    decltype(std::ranges::begin(std::declval<R&>()))>
+             || std::is_volatile_v<V>
+             || ! std::is_trivially_copyable_v<E>
+             || ! std::is_trivially_copy_assignable_v<E>)
+    return false;
+  else if constexpr (range_depth<E,R>() == 1)
+    return std::is_same_v<std::remove_cv_t<V>, E>;
+  else
+    return static_flat_size<E,V>() != dynamic_size
+        && sizeof(V) == static_flat_size<E,V>() * sizeof(E)
+        && bulk_range<E,V>();
+}
+
+// assign_range(l,i,r) assigns the flat elements of r to l from flat
+//                     index i, streaming; returns the end index
+//
+template <typename L, typename R>
+constexpr std::size_t assign_range(L& l, std::size_t i, R&& r)
+{
+  using E = remove_all_extents_t<L>;
+  for (auto&& e : r)
+    if constexpr (range_depth<E,R>() == 1)
+      flat_index(l, i++) = static_cast<decltype(e)>(e);
+    else
+      i = assign_range(l, i, e);
+  return i;
+}
+
+} // impl
+
 // assign_to customization point to specialize as a reference-wrapper
 //                                  with operator= overloads
 // invoked by assign() function for types with assign_to specialization
@@ -282,6 +447,11 @@ struct assign_to<L>
   constexpr L& operator=(R&& r) const
       noexcept(noexcept(flat_index(l) = flat_index((R&&)r)))
   {
+      if constexpr (bulk_copyable<L, R>)
+        if (! std::is_constant_evaluated()) {
+          impl::copy_bytes_n<sizeof l>(&l, &r);
+          return l;
+        }
       for (int i = 0; i != flat_size<L>; ++i)
           flat_index(l, i) = flat_index((R&&)r, i);
       return l;
@@ -292,11 +462,89 @@ struct assign_to<L>
   constexpr L& operator=(value_type const& r) const
       noexcept(noexcept(flat_index(l) = flat_index(r)))
   {
+      if constexpr (bulk_copyable<L, value_type const&>)
+        if (! std::is_constant_evaluated()) {
+          impl::copy_bytes_n<sizeof l>(&l, &r);
+          return l;
+        }
       for (int i = 0; i != flat_size<L>; ++i)
           flat_index(l, i) = flat_index(r, i);
       return l;
   }
 
+  // operator=(range) overload for sized ranges, maybe nested, of
+  //                  flat_size<L> elements; memcpy if bulk_range
+  //
+  template <typename R,
+            typename E = remove_all_extents_t<value_type>>
+    requires (! c_array<std::remove_cvref_t<R>>
+           && impl::range_depth<E,R>() != 0)
+  constexpr L& operator=(R&& r) const
+  {
+      constexpr std::size_t n = impl::static_flat_size<E,R>();
+      static_assert(n == impl::dynamic_size || n == flat_size<L>,
+                   "assign from range requires flat_size<L> elements.");
+      if constexpr (n == impl::dynamic_size)
+        if (impl::range_flat_size<E>(r) != flat_size<L>)
+          throw std::length_error("lml::assign: range size mismatch");
+      if constexpr (impl::bulk_range<E,R>() && c_array_unpadded<L>)
+        if (! std::is_constant_evaluated()) {
+          if constexpr (sizeof l != 0)
+            std::memcpy(&l, std::ranges::data(r), sizeof l);
+          return l;
+        }
+      impl::assign_range(l, 0, (R&&)r);
+      return l;
+  }
+
+};
+
+// assign_to<bounded_array> specialization for runtime-extent assignment
+// operator=(r) requires r.size() == l.size() and returns the bounded_array
+//
+template <bounded_array_type L>
+struct assign_to<L>
+{
+  std::remove_cvref_t<L> l;
+
+  using element_type = typename std::remove_cvref_t<L>::element_type;
+
+  // operator=({}) overload for emtpy braced-init
+  //
+  constexpr auto operator=(std::true_type) const
+    requires empty_list_assignable<element_type&>
+  {
+      for (std::size_t i = 0; i != l.flat_count(); ++i)
+          l.flat(i) = {};
+      return l;
+  }
+
+  // operator=(r) overload for bounded_array of the same extent
+  //
+  template <typename U>
+    requires assignable_from<element_type&, U&>
+  constexpr auto operator=(bounded_array<U> r) const
+  {
+      if constexpr (bulk_copyable<element_type(&)[1], U(&)[1]>)
+        if (! std::is_constant_evaluated()) {
+          if (auto n = l.size_bytes(); n != 0)
+            impl::move_bytes(l.data(), r.data(), n);
+          return l;
+        }
+      for (std::size_t i = 0; i != l.flat_count(); ++i)
+          l.flat(i) = r.flat(i);
+      return l;
+  }
+
+  // operator=(r) overload for C array lvalue of the same outer extent
+  //
+  template <c_array R>
+    requires assignable_from<element_type&, extent_removed_t<R&>>
+  constexpr auto operator=(R& r) const
+  {
+      using U = std::remove_extent_t<R>;
+      return *this = bounded_array<U>(r, std::extent_v<R>);
+  }
 };
 
 // assign(l) returns assign_to{l}, if assign_toable, else reference-to-l
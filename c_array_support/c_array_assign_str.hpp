@@ -0,0 +1,175 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_ASSIGN_STR_HPP
+#define LML_C_ARRAY_ASSIGN_STR_HPP
+/*
+  c_array_assign_str.hpp
+  ======================
+
+  Assignment of a string_view to a fixed-size char array field, with
+  padding and overflow policies; strncpy semantics and more, without
+  its byte loops.
+
+  Depends on <cstdint>, <cstring>, <stdexcept>, <string_view>
+  and "c_array_support.hpp"
+
+  Types:
+
+    lml::str_policy          flags: nul_pad, space_pad, nul_term, strict
+    lml::assign_str_to<P,C,N>  reference-wrapper for a C[N] buffer
+
+  Functions:
+
+    lml::assign_str<P>(buf)  returns assign_str_to for char or char8_t buf
+
+  Usage
+  =====
+    struct order { char sym[8]; char acct[12]; char note[32]; };
+    order o;
+    lml::assign_str(o.sym) = sv;          // NUL-padded, truncated (strncpy)
+    lml::assign_str<lml::str_policy::space_pad>(o.acct) = "A12";
+    using enum lml::str_policy;
+    lml::assign_str<nul_term | strict>(o.note) = s; // throws if s > 31
+
+  Policies, combined by |:
+
+    nul_pad    (default) pad with NUL bytes
+    space_pad  pad with spaces, for fixed-width text fields
+    nul_term   buf[N-1] is always NUL, so at most N-1 chars are stored
+    strict     throw std::length_error if sv doesn't fit, else truncate
+
+  A strict assignment that throws leaves the buffer unmodified.
+  operator= returns the array lvalue, as for lml::assign. The string may
+  overlap the buffer, e.g. a view of its own tail.
+
+  Performance
+  ===========
+  At runtime, buffers of up to 32 bytes are built in a local temporary,
+  so the string may alias the buffer: filled whole with the pad byte, a
+  constant-size memset, then the string copied in by two overlapping
+  loads and stores of the widest power of two that fits its length, and
+  the temporary stored whole. E.g. a 3 to 7 char name is two 4-byte
+  moves over an 8-byte store, then one 8-byte store to the buffer.
+  Larger buffers are a memmove plus a memset of the remainder.
+  Constant evaluation goes char by char.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include "c_array_support.hpp"
+
+#include "namespace.hpp"
+
+// str_policy flags for assign_str, combined by |
+//
+enum class str_policy : std::uint8_t
+{
+  nul_pad = 0,
+  space_pad = 1,
+  nul_term = 2,
+  strict = 4
+};
+
+constexpr str_policy operator|(str_policy a, str_policy b) noexcept
+{
+  return str_policy(std::uint8_t(a) | std::uint8_t(b));
+}
+constexpr bool operator&(str_policy a, str_policy b) noexcept
+{
+  return (std::uint8_t(a) & std::uint8_t(b)) != 0;
+}
+
+namespace impl {
+
+// copy_overlap(d,s,n) copies n <= 32 bytes by two overlapping moves of
+//                     the widest power of two <= n
+//
+inline void copy_overlap(void* d, void const* s, std::size_t n) noexcept
+{
+  auto dc = static_cast<unsigned char*>(d);
+  auto sc = static_cast<unsigned char const*>(s);
+  auto two = [&]<std::size_t W>(std::integral_constant<std::size_t, W>) {
+    unsigned char lo[W], hi[W];
+    std::memcpy(lo, sc, W);
+    std::memcpy(hi, sc + n - W, W);
+    std::memcpy(dc, lo, W);
+    std::memcpy(dc + n - W, hi, W);
+  };
+  if (n >= 16)
+    two(std::integral_constant<std::size_t, 16>{});
+  else if (n >= 8)
+    two(std::integral_constant<std::size_t, 8>{});
+  else if (n >= 4)
+    two(std::integral_constant<std::size_t, 4>{});
+  else if (n >= 2)
+    two(std::integral_constant<std::size_t, 2>{});
+  else if (n == 1)
+    *dc = *sc;
+}
+
+} // impl
+
+// assign_str_to<P,C,N> reference-wrapper for a C[N] string field,
+//                      assigned from basic_string_view<C> by policy P
+//
+template <str_policy P, typename C, std::size_t N>
+  requires (std::is_same_v<C, char> || std::is_same_v<C, char8_t>)
+struct assign_str_to
+{
+  C (&buf)[N];
+
+  static constexpr bool terminate = P & str_policy::nul_term;
+  static_assert(! terminate || N != 0,
+               "assign_str nul_term policy requires a non-empty buffer.");
+
+  // capacity the number of chars stored at most
+  static constexpr std::size_t capacity = N - terminate;
+  static constexpr C pad = P & str_policy::space_pad ? C(' ') : C();
+
+  constexpr auto& operator=(std::basic_string_view<C> sv) const
+  {
+    std::size_t n = sv.size();
+    if (n > capacity) {
+      if constexpr (P & str_policy::strict)
+        throw std::length_error("lml::assign_str: string too long");
+      n = capacity;
+    }
+    if (std::is_constant_evaluated()) {
+      for (std::size_t i = 0; i != N; ++i)
+        buf[i] = i < n ? sv[i] : pad;
+    }
+    else if constexpr (N != 0) {
+      if constexpr (N <= 32) {
+        C t[N];
+        std::memset(t, pad, N);
+        impl::copy_overlap(t, sv.data(), n);
+        std::memcpy(buf, t, N);
+      } else {
+        if (n != 0)
+          std::memmove(buf, sv.data(), n);
+        std::memset(buf + n, pad, N - n);
+      }
+    }
+    if constexpr (terminate)
+      buf[N - 1] = C();
+    return buf;
+  }
+};
+
+// assign_str<P>(buf) returns assign_str_to<P> for string field buf
+//
+template <str_policy P = str_policy::nul_pad, typename C, std::size_t N>
+constexpr assign_str_to<P, C, N> assign_str(C (&buf)[N]) noexcept
+{
+  return {buf};
+}
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_ASSIGN_STR_HPP
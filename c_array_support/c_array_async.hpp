@@ -0,0 +1,292 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_ASYNC_HPP
+#define LML_C_ARRAY_ASYNC_HPP
+/*
+  c_array_async.hpp
+  =================
+
+  Resumable chunked copy and compare of large C arrays, as C++20
+  coroutines, so that a single-threaded event loop can interleave a
+  long assign or equal_to with its other work.
+
+  Depends on <coroutine>, <cstring>, <exception>, <optional>,
+  "c_array_assign.hpp", "c_array_compare.hpp" and "c_array_bytes.hpp"
+  (and is empty if the compiler lacks coroutine support)
+
+  Usage
+  =====
+    // Drive by hand; each resume() processes one chunk
+    auto copy = lml::async_assign(big, other, 1 <<20);
+    while (copy.resume())
+      poll_io();
+
+    auto same = lml::async_equal_to(big, other);
+    while (same.resume())
+      poll_io();
+    bool eq = same.result();
+
+    // Or await, from a coroutine, resuming chunks on an executor
+    bool eq = co_await lml::async_equal_to(big, other).via(loop);
+
+  async_assign(l,r,chunk_bytes) returns a chunked_task<void> and
+  async_equal_to(l,r,chunk_bytes) a chunked_task<bool>. Tasks are lazy;
+  nothing is done until the first resume. Each resume processes at most
+  chunk_bytes of l (1MiB by default, at least one element) by the same
+  fast paths as lml::assign: one memmove per chunk for bulk_copyable
+  arrays, or memcmp for bytewise_comparable arrays (scalar elements with
+  unique object representations). async_equal_to finishes early on a
+  mismatch.
+
+  An executor is any type with ex.post(std::coroutine_handle<>) that
+  later resumes the handle; e.g. a queue drained by the event loop.
+  co_await task.via(ex) posts the task to ex, which then re-posts it
+  after every chunk so other posted work runs in between. The awaiting
+  coroutine resumes, within the executor, when the task completes.
+
+  The arrays are held by reference, so must outlive the task; they must
+  not be modified elsewhere until it completes. Exceptions thrown by
+  element assignment or comparison are rethrown by result(), or by the
+  co_await expression.
+*/
+
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <cstring>
+#include <exception>
+#include <optional>
+
+#include "c_array_assign.hpp"
+#include "c_array_compare.hpp"
+#include "c_array_bytes.hpp"
+
+#include "namespace.hpp"
+
+// executor<Ex> concept: Ex has a post(handle) function, to resume later
+//
+template <typename Ex>
+concept executor = requires (Ex& ex, std::coroutine_handle<> h)
+                   { ex.post(h); };
+
+namespace impl {
+
+template <typename T>
+struct chunk_result
+{
+  std::optional<T> value;
+  void return_value(T v) { value.emplace(std::move(v)); }
+  T get() { return std::move(*value); }
+};
+
+template <>
+struct chunk_result<void>
+{
+  void return_void() noexcept {}
+  void get() noexcept {}
+};
+
+// next_chunk awaitable, suspends between chunks, re-posting the task
+//  to its executor, if it has one
+//
+struct next_chunk
+{
+  bool await_ready() const noexcept { return false; }
+
+  template <typename P>
+  void await_suspend(std::coroutine_handle<P> h) const
+  {
+    if (auto& p = h.promise(); p.post)
+      p.post(p.executor, h);
+  }
+
+  void await_resume() const noexcept {}
+};
+
+} // impl
+
+// chunked_task<T> a lazy coroutine that does its work in chunks, one per
+//  resume(), returning a T result
+//
+template <typename T = void>
+class [[nodiscard]] chunked_task
+{
+ public:
+  struct promise_type : impl::chunk_result<T>
+  {
+    std::coroutine_handle<> continuation;
+    void* executor = nullptr;
+    void (*post)(void*, std::coroutine_handle<>) = nullptr;
+    std::exception_ptr error;
+
+    chunked_task get_return_object() noexcept
+    {
+      return chunked_task{handle::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    auto final_suspend() noexcept
+    {
+      struct resume_continuation
+      {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(handle h) const noexcept
+        {
+          if (auto c = h.promise().continuation)
+            return c;
+          return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+      };
+      return resume_continuation{};
+    }
+
+    void unhandled_exception() noexcept
+    {
+      error = std::current_exception();
+    }
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  chunked_task(chunked_task&& o) noexcept : h(o.h) { o.h = {}; }
+
+  chunked_task& operator=(chunked_task&& o) noexcept
+  {
+    if (this != &o) {
+      if (h) h.destroy();
+      h = o.h;
+      o.h = {};
+    }
+    return *this;
+  }
+
+  ~chunked_task() { if (h) h.destroy(); }
+
+  // resume() processes the next chunk; returns false once all are done
+  //
+  bool resume()
+  {
+    if (! h.done())
+      h.resume();
+    return ! h.done();
+  }
+
+  bool done() const noexcept { return h.done(); }
+
+  // result() the result, or rethrows the exception, once done()
+  //
+  T result()
+  {
+    if (h.promise().error)
+      std::rethrow_exception(h.promise().error);
+    return h.promise().get();
+  }
+
+  // via(ex) awaitable that runs the remaining chunks posted on ex
+  //
+  template <executor Ex>
+  auto via(Ex& ex) &&
+  {
+    struct awaiter
+    {
+      chunked_task task;
+      Ex& ex;
+
+      bool await_ready() const noexcept { return task.done(); }
+
+      void await_suspend(std::coroutine_handle<> c)
+      {
+        auto& p = task.h.promise();
+        p.continuation = c;
+        p.executor = &ex;
+        p.post = [](void* e, std::coroutine_handle<> h) {
+          static_cast<Ex*>(e)->post(h);
+        };
+        ex.post(task.h);
+      }
+
+      T await_resume() { return task.result(); }
+    };
+    return awaiter{std::move(*this), ex};
+  }
+
+ private:
+  handle h;
+
+  explicit chunked_task(handle c) noexcept : h(c) {}
+};
+
+namespace impl {
+
+template <typename E>
+constexpr std::size_t chunk_elements(std::size_t chunk_bytes) noexcept
+{
+  return chunk_bytes < sizeof(E) ? 1 : chunk_bytes / sizeof(E);
+}
+
+} // impl
+
+// async_assign(l,r,chunk_bytes) chunked lml::assign(l) = r
+//
+template <c_array L, c_array R,
+          typename E = remove_all_extents_t<L>>
+  requires assignable_from<L&, R&>
+chunked_task<> async_assign(L& l, R& r, std::size_t chunk_bytes = 1 << 20)
+{
+  constexpr std::size_t n = flat_size<L>;
+  const auto step = impl::chunk_elements<E>(chunk_bytes);
+  for (std::size_t i = 0; i != n;)
+  {
+    auto end = n - i > step ? i + step : n;
+    if constexpr (bulk_copyable<L&, R&>)
+      std::memmove(&flat_index(l, i), &flat_index(r, i),
+                   (end - i) * sizeof(E));
+    else
+      for (auto j = i; j != end; ++j)
+        flat_index(l, j) = flat_index(r, j);
+    i = end;
+    if (i != n)
+      co_await impl::next_chunk{};
+  }
+}
+
+// async_equal_to(l,r,chunk_bytes) chunked lml::equal_to{}(l,r)
+//
+template <c_array L, c_array R,
+          typename E = remove_all_extents_t<std::remove_const_t<L>>>
+  requires equality_comparable_with<L&, R&>
+chunked_task<bool> async_equal_to(L& l, R& r,
+                                  std::size_t chunk_bytes = 1 << 20)
+{
+  constexpr std::size_t n = flat_size<L>;
+  const auto step = impl::chunk_elements<E>(chunk_bytes);
+  for (std::size_t i = 0; i != n;)
+  {
+    auto end = n - i > step ? i + step : n;
+    if constexpr (bytewise_comparable<L, R>)
+    {
+      if (std::memcmp(&flat_index(l, i), &flat_index(r, i),
+                      (end - i) * sizeof(E)) != 0)
+        co_return false;
+    }
+    else
+      for (auto j = i; j != end; ++j)
+        if (flat_index(l, j) != flat_index(r, j))
+          co_return false;
+    i = end;
+    if (i != n)
+      co_await impl::next_chunk{};
+  }
+  co_return true;
+}
+
+#include "namespace.hpp"
+
+#endif // __cpp_impl_coroutine
+
+#endif // LML_C_ARRAY_ASYNC_HPP
@@ -0,0 +1,89 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_BIT_CAST_HPP
+#define LML_C_ARRAY_BIT_CAST_HPP
+/*
+  c_array_bit_cast.hpp
+  ====================
+
+  lml::bit_cast, c.f. std::bit_cast, extended to cast to C array types,
+  constexpr.
+
+  Depends on <bit>, "c_array_support.hpp" and "c_array_aligned.hpp"
+
+  Usage
+  =====
+    constexpr std::uint8_t bytes[16] {...};
+
+    auto words = lml::bit_cast<std::uint32_t[4]>(bytes);
+    std::uint32_t w = words[0];         // words is lml::array<uint32_t,4>
+    std::uint32_t (&ws)[4] = words;     // which converts to uint32_t[4]&
+
+    struct v128 { std::uint64_t lo, hi; };
+    v128 v = lml::bit_cast<v128>(bytes);  // array source, as std::
+
+    std::uint16_t halves[8];
+    lml::bit_cast(halves, v);           // or into an array out-parameter
+
+  std::bit_cast already accepts a C array source; it can't return an
+  array. lml::bit_cast<To>(from) returns an array_of_t<To>, that is an
+  lml::array aggregate wrapping the To array (see c_array_aligned.hpp)
+  if To is a C array, else it's std::bit_cast<To>(from).
+  lml::bit_cast(to,from) writes the bits of from into to.
+
+  To and From must be trivially copyable with sizeof(To) == sizeof(From);
+  for arrays, flat_size<A> * sizeof(element). Like std::bit_cast, these
+  are constexpr (unless either type holds pointers or unions) and compile
+  to register moves, or a memcpy when too large.
+*/
+
+#include <bit>
+
+#include "c_array_support.hpp"
+#include "c_array_aligned.hpp"
+
+#include "namespace.hpp"
+
+// bit_castable<To,From> concept: From bits can be reinterpreted as a To
+//
+template <typename To, typename From>
+concept bit_castable = sizeof(To) == sizeof(From)
+                    && std::is_trivially_copyable_v<To>
+                    && std::is_trivially_copyable_v<From>;
+
+// bit_cast<To>(from) the bits of from as a To, or as an array_of_t<To>
+//                    if To is a C array
+//
+template <typename To, typename From>
+  requires bit_castable<std::remove_cv_t<To>, From>
+constexpr auto bit_cast(From const& from) noexcept
+{
+  if constexpr (c_array<To>)
+    return std::bit_cast<array_of_t<To>>(from);
+  else
+    return std::bit_cast<std::remove_cv_t<To>>(from);
+}
+
+// bit_cast(to,from) assigns the bits of from to to, which may be an array
+//
+template <typename To, typename From>
+  requires bit_castable<To, From>
+        && (! std::is_const_v<remove_all_extents_t<To>>)
+constexpr void bit_cast(To& to, From const& from) noexcept
+{
+  if constexpr (c_array<To>)
+  {
+    auto const bits = std::bit_cast<array_of_t<To>>(from);
+    for (std::size_t i = 0; i != flat_size<To>; ++i)
+      flat_index(to, i) = flat_index(bits.data, i);
+  }
+  else
+    to = std::bit_cast<To>(from);
+}
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_BIT_CAST_HPP
@@ -0,0 +1,253 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_BLOCK_HASH_HPP
+#define LML_C_ARRAY_BLOCK_HASH_HPP
+/*
+  c_array_block_hash.hpp
+  ======================
+
+  block_hashed<A,BlockBytes> wraps a reference to a large C array and
+  maintains a hash tree (Merkle tree) over its bytes, split into blocks.
+  Writes through the wrapper mark blocks dirty; rehash() then rehashes
+  only the dirty blocks, in parallel, and updates their ancestors.
+
+  Depends on <bit>, <vector>, "c_array_hash.hpp", "c_array_assign.hpp",
+  "dirty_bits.hpp" and "thread_pool.hpp"
+
+  Usage
+  =====
+    static std::uint32_t big[1<<28];
+    lml::block_hashed<std::uint32_t[1<<28]> bh{big};  // hashes all
+
+    bh.set(12345, 42u);      // write an element, marks its block dirty
+    bh.write(7) += 1;        // reference to element, marks block dirty
+    bh.assign(other_array);  // bulk assign, marks all blocks dirty
+
+    lml::assign(bh.writable()) = {};   // untracked write, so then
+    bh.mark_all_dirty();               // mark the modified blocks
+
+    auto root = bh.rehash(); // rehash dirty blocks -> new root hash
+
+    bh.for_each_divergent_block(other_bh, [](std::size_t block) {...});
+
+  The tree is stored as an implicit binary heap of 2*L nodes, where L is
+  block_count rounded up to a power of two; leaf hash of block b is at
+  node L+b, node i has children 2i and 2i+1, and the root is at node 1.
+  Padding leaves, beyond block_count, hash to zero.
+
+  Block hashes are lml::impl::hash_bytes of the block bytes; the final
+  block may be short. Tree nodes are hash_combine of their two children.
+  So divergent regions of two same-typed arrays are found by descending
+  from the roots through differing nodes only, O(log n) per divergence.
+
+  The hashed array must be modified through the wrapper or the dirty
+  blocks marked explicitly. Hashes are only valid after rehash().
+*/
+
+#include <bit>
+#include <vector>
+
+#include "c_array_hash.hpp"
+#include "c_array_assign.hpp"
+#include "dirty_bits.hpp"
+#include "thread_pool.hpp"
+
+#include "namespace.hpp"
+
+// block_hashed<A,BlockBytes> reference wrapper for array A, tracking a
+//  hash tree of the array's bytes in blocks of BlockBytes size
+//
+template <c_array_unpadded A, std::size_t BlockBytes = 4096>
+  requires (! std::is_reference_v<A>
+         && std::is_trivially_copyable_v<remove_all_extents_t<A>>
+         && BlockBytes != 0
+         && BlockBytes % sizeof(remove_all_extents_t<A>) == 0)
+class block_hashed
+{
+ public:
+  using value_type = A;
+  using element_type = remove_all_extents_t<A>;
+  using hash_type = std::uint64_t;
+
+  static constexpr std::size_t block_bytes = BlockBytes;
+  static constexpr std::size_t block_size = BlockBytes
+                                          / sizeof(element_type);
+  static constexpr std::size_t block_count = (flat_size<A> + block_size
+                                                 - 1) / block_size;
+  static constexpr std::size_t leaf_base = std::bit_ceil(block_count);
+
+  // Below this many bytes of dirty blocks rehash() is single threaded
+  static constexpr std::size_t parallel_threshold_bytes = 1u << 20;
+
+  explicit block_hashed(A& a) : arr(a)
+  {
+    mark_all_dirty();
+    rehash();
+  }
+
+  // Read access, the wrapped array by const reference
+  //
+  A const& get() const noexcept { return arr; }
+  operator A const&() const noexcept { return arr; }
+
+  element_type const& operator[](std::size_t i) const noexcept
+  {
+    return flat_index(arr, i);
+  }
+
+  // Tracked writes, by flat index
+  //
+  template <typename V>
+    requires std::is_assignable_v<element_type&, V&&>
+  void set(std::size_t i, V&& v)
+  {
+    flat_index(arr, i) = (V&&)v;
+    dirty.set(i / block_size);
+  }
+
+  element_type& write(std::size_t i) noexcept
+  {
+    dirty.set(i / block_size);
+    return flat_index(arr, i);
+  }
+
+  template <typename R>
+    requires requires (A& l, R&& r) { assign_to<A&>{l} = (R&&)r; }
+  void assign(R&& r)
+  {
+    assign_to<A&>{arr} = (R&&)r;
+    mark_all_dirty();
+  }
+
+  void assign(A const& r)
+  {
+    assign_to<A&>{arr} = r;
+    mark_all_dirty();
+  }
+
+  // Untracked write access; modified blocks must be marked dirty
+  //
+  A& writable() noexcept { return arr; }
+
+  void mark_dirty(std::size_t first, std::size_t count) noexcept
+  {
+    if (count != 0)
+      dirty.set_range(first / block_size,
+                      (first + count - 1) / block_size + 1);
+  }
+
+  void mark_all_dirty() noexcept { dirty.set_all(); }
+
+  bool is_dirty(std::size_t block) const noexcept
+  {
+    return dirty.test(block);
+  }
+
+  std::size_t dirty_count() const noexcept { return dirty.count(); }
+
+  // rehash() rehashes dirty blocks and their ancestors, returns root hash
+  //
+  hash_type rehash()
+  {
+    if (! dirty.any())
+      return root_hash();
+
+    std::vector<std::size_t> nodes;
+    nodes.reserve(dirty.count());
+    dirty.for_each_set([&](std::size_t b) { nodes.push_back(b); });
+    dirty.clear();
+
+    hash_blocks(nodes);
+
+    // Recompute ancestors, level by level; nodes remain sorted, unique
+    for (auto& i : nodes)
+      i += leaf_base;
+    while (nodes.front() > 1)
+    {
+      std::size_t n = 0;
+      for (std::size_t k = 0; k != nodes.size(); ++k)
+        if (auto p = nodes[k] / 2; n == 0 || nodes[n-1] != p)
+          nodes[n++] = p;
+      nodes.resize(n);
+      for (auto i : nodes)
+        tree[i] = impl::hash_combine(tree[2*i], tree[2*i + 1]);
+    }
+    return root_hash();
+  }
+
+  // Hash accessors, valid after rehash()
+  //
+  hash_type root_hash() const noexcept { return tree[1]; }
+
+  hash_type block_hash(std::size_t block) const noexcept
+  {
+    return tree[leaf_base + block];
+  }
+
+  // node_hash(i) hash of tree node i, in binary heap order, root i == 1
+  //
+  hash_type node_hash(std::size_t i) const noexcept { return tree[i]; }
+
+  // for_each_divergent_block(other, f) calls f(block) in block order
+  //  for each block whose hash differs from the other's block hash,
+  //  visiting only the tree nodes that differ
+  //
+  template <typename F>
+  void for_each_divergent_block(block_hashed const& other, F&& f) const
+  {
+    divergent(other, 1, f);
+  }
+
+ private:
+  A& arr;
+  std::vector<hash_type> tree = std::vector<hash_type>(2 * leaf_base);
+  dirty_bits dirty = dirty_bits(block_count);
+
+  void hash_block(std::size_t b) noexcept
+  {
+    auto bytes = reinterpret_cast<unsigned char const*>(&arr);
+    auto offset = b * BlockBytes;
+    auto n = sizeof(A) - offset < BlockBytes ? sizeof(A) - offset
+                                             : BlockBytes;
+    tree[leaf_base + b] = impl::hash_bytes(bytes + offset, n);
+  }
+
+  // hash_blocks(blocks) hashes blocks on the par::thread_pool, in slices
+  //  of at least parallel_threshold_bytes
+  //
+  void hash_blocks(std::vector<std::size_t> const& blocks)
+  {
+    constexpr auto grain = (parallel_threshold_bytes + BlockBytes - 1)
+                         / BlockBytes;
+    par::thread_pool::instance().for_range(blocks.size(), grain,
+      [&](std::size_t k, std::size_t end) {
+        for (; k != end; ++k)
+          hash_block(blocks[k]);
+      });
+  }
+
+  template <typename F>
+  void divergent(block_hashed const& other, std::size_t i, F& f) const
+  {
+    if (tree[i] == other.tree[i])
+      return;
+    if (i >= leaf_base)
+    {
+      if (i - leaf_base < block_count)
+        f(i - leaf_base);
+      return;
+    }
+    divergent(other, 2*i, f);
+    divergent(other, 2*i + 1, f);
+  }
+};
+
+template <c_array_unpadded A>
+block_hashed(A&) -> block_hashed<A>;
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_BLOCK_HASH_HPP
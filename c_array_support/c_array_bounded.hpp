@@ -0,0 +1,144 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_BOUNDED_HPP
+#define LML_C_ARRAY_BOUNDED_HPP
+/*
+  c_array_bounded.hpp
+  ===================
+
+  Runtime-bounded arrays; a pointer to T plus a runtime outer extent,
+  with T's element type and inner extents static, for buffers from C
+  APIs to take the lml array paths.
+
+  Depends on "c_array_support.hpp"
+
+  Class template:
+
+    lml::bounded_array<T>  view of n elements T at p, T possibly an array
+
+  Concepts (declared in c_array_support.hpp, with bounded_array):
+
+    lml::bounded_array_type<B>  B is a bounded_array, under cvref
+
+  Functions:
+
+    lml::bounded(p,n)       bounded_array<T> of T* p and runtime extent n
+    lml::bounded(a,n)       of an unbounded array T(&)[] and extent n
+    lml::bounded(a)         of a C array T[N]..., outer extent N
+
+  Usage
+  =====
+    void f(float* p, std::size_t n, float const (*q)[3], std::size_t m)
+    {
+      auto b = lml::bounded(p, n);        // bounded_array<float>
+      lml::fill(b, 0.f);
+      auto rows = lml::bounded(q, m);     // bounded_array<float const[3]>
+      bool eq = lml::equal_to{}(rows, rows);
+      auto h = lml::hash{}(rows);         // equals hash of float[m][3]
+    }
+
+  A bounded_array is a trivially copyable view, like span, that's
+  accepted by lml::assign, equal_to, compare_three_way, hash, fill and
+  find (with their headers). They take the same runtime paths as for
+  C arrays, with a runtime byte count: the copy and mismatch kernels,
+  fill_n and find_n, and hash_bytes; bounded(a) of a C array hashes,
+  and compares, equal to a. Constant evaluation goes elementwise.
+
+  Comparison is lexicographic over the flattened elements, then by
+  outer extent; bounded_arrays of different extents are not equal.
+  Assignment requires equal extents (a precondition, not checked).
+  Inner array types must be unpadded for the runtime paths.
+*/
+
+#include "c_array_support.hpp"
+
+#include "namespace.hpp"
+
+// bounded_array<T> a view of a runtime number of elements T,
+//                  with T possibly an array of static extents
+//
+template <typename T>
+  requires (std::is_object_v<T> && ! std::is_unbounded_array_v<T>)
+class bounded_array
+{
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+
+  constexpr bounded_array(T* p, std::size_t n) noexcept
+    : data_{p}, size_{n} {}
+
+  // bounded_array<T const> from bounded_array<T>
+  template <typename U>
+    requires std::is_same_v<T, U const> && (! std::is_same_v<T, U>)
+  constexpr bounded_array(bounded_array<U> b) noexcept
+    : data_{b.data()}, size_{b.size()} {}
+
+  constexpr T* data() const noexcept { return data_; }
+
+  // size() the runtime outer extent
+  constexpr std::size_t size() const noexcept { return size_; }
+
+  // flat_count() the number of flattened elements
+  constexpr std::size_t flat_count() const noexcept
+  {
+    return size_ * flat_size<T>;
+  }
+  constexpr std::size_t size_bytes() const noexcept
+  {
+    return size_ * sizeof(T);
+  }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+
+  constexpr T& operator[](std::size_t i) const noexcept
+  {
+    return data_[i];
+  }
+
+  // flat(i) the i'th flattened element
+  constexpr auto& flat(std::size_t i) const noexcept
+  {
+    if constexpr (c_array<T>)
+      return flat_index(data_[i / flat_size<T>], i % flat_size<T>);
+    else
+      return data_[i];
+  }
+
+  constexpr T* begin() const noexcept { return data_; }
+  constexpr T* end() const noexcept { return data_ + size_; }
+
+ private:
+  T* data_;
+  std::size_t size_;
+};
+
+// bounded(p,n) bounded_array of n elements T at p
+//
+template <typename T>
+constexpr bounded_array<T> bounded(T* p, std::size_t n) noexcept
+{
+  return {p, n};
+}
+
+// bounded(a,n) bounded_array of the first n elements of unbounded array a
+//
+template <typename T>
+constexpr bounded_array<T> bounded(T (&a)[], std::size_t n) noexcept
+{
+  return {a, n};
+}
+
+// bounded(a) bounded_array of C array a; outer extent N
+//
+template <typename T, std::size_t N>
+constexpr bounded_array<T> bounded(T (&a)[N]) noexcept
+{
+  return {a, N};
+}
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_BOUNDED_HPP
@@ -0,0 +1,390 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_BYTES_HPP
+#define LML_C_ARRAY_BYTES_HPP
+/*
+  c_array_bytes.hpp
+  =================
+
+  The byte-level runtime paths of lml::assign, equal_to, compare_three_way
+  and less, and of the algorithms of c_array_algorithm.hpp; the entry
+  points to the dispatched kernels of c_array_kernels.hpp, declared only,
+  so that these headers don't depend on the dispatch machinery unless
+  it's asked for.
+
+  Depends on <bit>, <cstdint>, <cstring> and "c_array_support.hpp"
+  (plus <xmmintrin.h> with MSVC on x86, for _mm_prefetch; and includes
+  "c_array_kernels.hpp" if LML_KERNELS_DISPATCH is defined)
+
+  Traits:
+
+    lml::kernel_min_bytes          byte size from which kernels are used
+    lml::bytewise_comparable<L,R>  arrays L and R of scalar elements
+                                   are equal iff their bytes are equal
+
+  Functions (impl):
+
+    mismatch_bytes(l,r,n)  offset of the first differing byte, or n
+    move_bytes(d,s,n)      memmove
+    copy_bytes_n<B>(d,s)   moves B bytes; canonical, keyed by byte count
+    equal_bytes_n<B>(l,r)  true if B bytes are equal; canonical
+
+    fill_elements(d,v,n)   stores v in n elements at d
+    find_element(p,v,n)    index of the first of n elements equal to v
+    gather_elements(d,s,idx,n,w,pf)  d[i] = s[idx[i]], 32-bit indices
+    reverse_elements(p,n,w)          reverses n elements at p
+
+  The element entry points take elements of 1, 2, 4 or 8 bytes as the
+  unsigned integer of their size, uint_bytes<N> (w bytes, 4 or 8 for
+  gather).
+
+  Usage
+  =====
+    Indirectly, via the runtime paths of the lml functors; to dispatch
+    them by CPU tier, header-only, define LML_KERNELS_DISPATCH, or link
+    the c_array_kernels library (which defines LML_KERNELS_LIB).
+
+  There are three builds, chosen by macro, for the whole program:
+
+    LML_KERNELS_LIB       the entry points are declared here and defined
+                          in the c_array_kernels library, by the kernels
+                          of the active tier
+    LML_KERNELS_DISPATCH  they're inline, by the kernels of the active
+                          tier; this header then includes
+                          c_array_kernels.hpp, its intrinsics and tables
+    neither (default)     they're inline, portable, with no dispatch;
+                          memmove, memset and memchr, a loop comparing
+                          8-byte words, and element loops for the
+                          compiler to vectorize for the baseline target
+
+  copy_bytes_n and equal_bytes_n are memmove and memcmp of known size
+  below kernel_min_bytes, which compilers expand inline; from it, the
+  entry points, or memcmp in the default build.
+*/
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include "c_array_support.hpp"
+
+#include "namespace.hpp"
+
+// Arrays smaller than this are compared elementwise, inline
+inline constexpr std::size_t kernel_min_bytes = 64;
+
+// bytewise_comparable<L,R> true if arrays L and R are equal iff their
+//  bytes are equal; unpadded, same scalar elements with unique
+//  representations (class elements may define their own == and <=>)
+//
+template <typename L, typename R,
+          typename EL = remove_all_extents_t<std::remove_reference_t<L>>,
+          typename ER = remove_all_extents_t<std::remove_reference_t<R>>>
+inline constexpr bool bytewise_comparable = c_array_unpadded<L>
+                                   && c_array_unpadded<R>
+                                   && same_extents<std::remove_cvref_t<L>,
+                                                   std::remove_cvref_t<R>>
+                                   && std::is_same_v<std::remove_cv_t<EL>,
+                                                     std::remove_cv_t<ER>>
+                                   && ! std::is_volatile_v<EL>
+                                   && ! std::is_volatile_v<ER>
+                                   && std::is_scalar_v<EL>
+                   && std::has_unique_object_representations_v<
+                                                   std::remove_cv_t<EL>>;
+
+namespace impl {
+
+inline std::size_t mismatch_tail(unsigned char const* a,
+                                 unsigned char const* b,
+                                 std::size_t i, std::size_t n) noexcept
+{
+  while (i != n && a[i] == b[i])
+    ++i;
+  return i;
+}
+
+// mismatch_words(l,r,n) offset of the first differing byte of n, or n;
+//                       portable, by 8-byte words
+//
+inline std::size_t mismatch_words(void const* l, void const* r,
+                                  std::size_t n) noexcept
+{
+  auto a = static_cast<unsigned char const*>(l);
+  auto b = static_cast<unsigned char const*>(r);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    std::uint64_t x, y;
+    std::memcpy(&x, a + i, 8);
+    std::memcpy(&y, b + i, 8);
+    if (x != y)
+    {
+      if constexpr (std::endian::native == std::endian::little)
+        return i + std::countr_zero(x ^ y) / 8;
+      else
+        return i + std::countl_zero(x ^ y) / 8;
+    }
+  }
+  return mismatch_tail(a, b, i, n);
+}
+
+// uint_bytes<N> the unsigned integer type of N bytes, N = 1, 2, 4 or 8
+//
+template <std::size_t N>
+using uint_bytes = std::conditional_t<N == 1, std::uint8_t,
+                   std::conditional_t<N == 2, std::uint16_t,
+                   std::conditional_t<N == 4, std::uint32_t,
+                   std::conditional_t<N == 8, std::uint64_t, void>>>>;
+
+// load<U>(p,i) element i of type U at p, by memcpy
+//
+template <typename U>
+inline U load(unsigned char const* p, std::size_t i) noexcept
+{
+  U u;
+  std::memcpy(&u, p + i * sizeof(U), sizeof(U));
+  return u;
+}
+
+// prefetch(p) hints that p will be read soon; a no-op where unsupported
+//
+inline void prefetch(void const* p) noexcept
+{
+#if defined(__GNUC__)
+  __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<char const*>(p), _MM_HINT_T0);
+#else
+  (void)p;
+#endif
+}
+
+// find_loop tests blocks of 16 elements branch-free, to vectorize
+//
+template <typename U>
+inline std::size_t find_loop(void const* q, U v, std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char const*>(q);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    bool any = false;
+    for (std::size_t j = 0; j != 16; ++j)
+      any |= load<U>(p, i + j) == v;
+    if (any)
+      break;
+  }
+  while (i != n && load<U>(p, i) != v)
+    ++i;
+  return i;
+}
+
+// Prefetch distance of the gather loops and kernels, in elements
+inline constexpr std::size_t gather_ahead = 64;
+
+// fill_loop(d,v,n), find_loop(p,v,n) access elements by memcpy, as the
+//  bytes of any element type of their size; plain loads and stores
+//
+template <typename U>
+inline void fill_loop(void* d, U v, std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char*>(d);
+  for (std::size_t i = 0; i != n; ++i)
+    std::memcpy(p + i * sizeof(U), &v, sizeof(U));
+}
+
+// gather_loop(d,s,idx,i,n,pf) gathers elements U [i,n) by memcpy,
+//  prefetching from gather_ahead on if pf
+//
+template <typename U>
+inline void gather_loop(void* d, void const* s, void const* idx,
+                        std::size_t i, std::size_t n, bool pf) noexcept
+{
+  auto dp = static_cast<unsigned char*>(d);
+  auto sp = static_cast<unsigned char const*>(s);
+  auto ip = static_cast<unsigned char const*>(idx);
+  for (; i != n; ++i)
+  {
+    if (pf && i + gather_ahead < n)
+      prefetch(sp + load<std::uint32_t>(ip, i + gather_ahead)
+                  * std::size_t{sizeof(U)});
+    std::memcpy(dp + i * sizeof(U),
+                sp + load<std::uint32_t>(ip, i) * std::size_t{sizeof(U)},
+                sizeof(U));
+  }
+}
+
+// reverse_loop<U>(p,i,j) reverses elements U [i,j) at p by swaps
+//
+template <typename U>
+inline void reverse_loop(unsigned char* p, std::size_t i,
+                         std::size_t j) noexcept
+{
+  for (; i + 1 < j; ++i, --j)
+  {
+    U a = load<U>(p, i), b = load<U>(p, j - 1);
+    std::memcpy(p + i * sizeof(U), &b, sizeof(U));
+    std::memcpy(p + (j - 1) * sizeof(U), &a, sizeof(U));
+  }
+}
+
+// reverse_range(p,i,j,w) reverses elements [i,j) of w bytes at p
+//
+inline void reverse_range(unsigned char* p, std::size_t i,
+                          std::size_t j, std::size_t w) noexcept
+{
+  switch (w) {
+    case 1:  return reverse_loop<std::uint8_t>(p, i, j);
+    case 2:  return reverse_loop<std::uint16_t>(p, i, j);
+    case 4:  return reverse_loop<std::uint32_t>(p, i, j);
+    default: return reverse_loop<std::uint64_t>(p, i, j);
+  }
+}
+
+#if defined(LML_KERNELS_LIB) || defined(LML_KERNELS_DISPATCH)
+
+inline constexpr bool kernels_dispatched = true;
+
+#if defined(LML_KERNELS_LIB)
+#define LML_BYTES_ENTRY
+#else
+#define LML_BYTES_ENTRY inline
+#endif
+
+// mismatch_bytes(l,r,n), move_bytes(d,s,n) the mismatch and copy kernels
+//  of the active tier; defined in c_array_kernels.hpp
+//
+LML_BYTES_ENTRY std::size_t mismatch_bytes(void const* l, void const* r,
+                                           std::size_t n) noexcept;
+LML_BYTES_ENTRY void move_bytes(void* d, void const* s,
+                                std::size_t n) noexcept;
+
+// fill_elements, find_element, gather_elements and reverse_elements the
+//  element kernels fill_n, find_n, gather_n and reverse_n of the active
+//  tier; defined in c_array_kernels.hpp
+//
+LML_BYTES_ENTRY void fill_elements(void* d, std::uint8_t v,
+                                   std::size_t n) noexcept;
+LML_BYTES_ENTRY void fill_elements(void* d, std::uint16_t v,
+                                   std::size_t n) noexcept;
+LML_BYTES_ENTRY void fill_elements(void* d, std::uint32_t v,
+                                   std::size_t n) noexcept;
+LML_BYTES_ENTRY void fill_elements(void* d, std::uint64_t v,
+                                   std::size_t n) noexcept;
+
+LML_BYTES_ENTRY std::size_t find_element(void const* p, std::uint8_t v,
+                                         std::size_t n) noexcept;
+LML_BYTES_ENTRY std::size_t find_element(void const* p, std::uint16_t v,
+                                         std::size_t n) noexcept;
+LML_BYTES_ENTRY std::size_t find_element(void const* p, std::uint32_t v,
+                                         std::size_t n) noexcept;
+LML_BYTES_ENTRY std::size_t find_element(void const* p, std::uint64_t v,
+                                         std::size_t n) noexcept;
+
+LML_BYTES_ENTRY void gather_elements(void* d, void const* s,
+                                     void const* idx, std::size_t n,
+                                     std::size_t w, bool pf) noexcept;
+LML_BYTES_ENTRY void reverse_elements(void* p, std::size_t n,
+                                      std::size_t w) noexcept;
+
+#undef LML_BYTES_ENTRY
+
+#else
+
+inline constexpr bool kernels_dispatched = false;
+
+inline std::size_t mismatch_bytes(void const* l, void const* r,
+                                  std::size_t n) noexcept
+{
+  return mismatch_words(l, r, n);
+}
+
+inline void move_bytes(void* d, void const* s, std::size_t n) noexcept
+{
+  std::memmove(d, s, n);
+}
+
+inline void fill_elements(void* d, std::uint8_t v, std::size_t n) noexcept
+{
+  std::memset(d, v, n);
+}
+
+template <typename U>
+inline void fill_elements(void* d, U v, std::size_t n) noexcept
+{
+  fill_loop(d, v, n);
+}
+
+inline std::size_t find_element(void const* p, std::uint8_t v,
+                                std::size_t n) noexcept
+{
+  auto f = n ? std::memchr(p, v, n) : nullptr;
+  return f ? static_cast<std::size_t>(static_cast<char const*>(f)
+                                    - static_cast<char const*>(p)) : n;
+}
+
+template <typename U>
+inline std::size_t find_element(void const* p, U v, std::size_t n) noexcept
+{
+  return find_loop(p, v, n);
+}
+
+inline void gather_elements(void* d, void const* s, void const* idx,
+                            std::size_t n, std::size_t w, bool pf) noexcept
+{
+  if (w == 4)
+    gather_loop<std::uint32_t>(d, s, idx, 0, n, pf);
+  else
+    gather_loop<std::uint64_t>(d, s, idx, 0, n, pf);
+}
+
+inline void reverse_elements(void* p, std::size_t n,
+                             std::size_t w) noexcept
+{
+  reverse_range(static_cast<unsigned char*>(p), 0, n, w);
+}
+
+#endif
+
+// copy_bytes_n<B>(d,s) copies B bytes from s to d; canonical, keyed by
+//                      byte count, by move_bytes from kernel_min_bytes
+//
+template <std::size_t B>
+inline void copy_bytes_n(void* d, void const* s) noexcept
+{
+  if constexpr (B >= kernel_min_bytes)
+    move_bytes(d, s, B);
+  else if constexpr (B != 0)
+    std::memmove(d, s, B);
+}
+
+// equal_bytes_n<B>(l,r) true if B bytes at l and r are equal; canonical,
+//                       keyed by byte count
+//
+template <std::size_t B>
+inline bool equal_bytes_n(void const* l, void const* r) noexcept
+{
+  if constexpr (kernels_dispatched && B >= kernel_min_bytes)
+    return mismatch_bytes(l, r, B) == B;
+  else if constexpr (B != 0)
+    return std::memcmp(l, r, B) == 0;
+  else
+    return true;
+}
+
+} // impl
+
+#include "namespace.hpp"
+
+#if defined(LML_KERNELS_DISPATCH) && ! defined(LML_KERNELS_LIB)
+#include "c_array_kernels.hpp"
+#endif
+
+#endif // LML_C_ARRAY_BYTES_HPP
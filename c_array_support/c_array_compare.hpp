@@ -13,12 +13,22 @@
   extended to support C arrays. Only same-size, same shape, arrays are
   considered comparable. Multidimensional arrays compare as-if flat.
 
-  Depends on <compare> and c_array_support.hpp
+  Depends on <compare>, c_array_support.hpp and c_array_bytes.hpp
 
   Avoids <algorithm> or <functional> dependency, implementing algorithms
   similar to std::lexicographical_compare_three_way and ranges equality
-  for same-shape C arrays by flat indexing rather than by recursion
-  (currently lacking optimizations such as memcmp specializations).
+  for same-shape C arrays by flat indexing rather than by recursion.
+  At runtime, bytewise_comparable arrays are compared by mismatch_bytes
+  of c_array_bytes.hpp, which finds the first differing element, and
+  only that element is compared; it's the dispatched mismatch kernel of
+  c_array_kernels.hpp if opted in, else a portable word loop. equal_to
+  compares them by equal_bytes_n<sizeof(L)>, at any size, one
+  instantiation per byte count. Arrays of class elements, which may
+  define their own == and <=>, are never compared by bytes.
+
+  bounded_arrays of c_array_bounded.hpp get == and <=> on the same
+  paths with a runtime byte count, so the functors accept them too
+  (include c_array_bounded.hpp to use them).
 
   Concepts:
 
@@ -77,6 +87,7 @@
 #include <compare>
 
 #include "c_array_support.hpp"
+#include "c_array_bytes.hpp"
 
 #ifndef __UINTPTR_TYPE__
 #include <cstdint>
@@ -171,8 +182,71 @@ concept pointer_less_than_comparable_with =
       && ! requires(P&& l, Q&& r)
            { static_cast<P&&>(l).operator<(static_cast<Q&&>(r)); }
      );
+
+// kernel_comparable<L,R> arrays compared by mismatch kernel at runtime
+//
+template <typename L, typename R>
+inline constexpr bool kernel_comparable = bytewise_comparable<L,R>
+                                       && sizeof(L) >= kernel_min_bytes;
+
+// kernel_mismatch(l,r) flat index of the first differing element, or
+//                      flat_size if none; for bytewise_comparable arrays
+//
+template <c_array L, c_array R>
+std::size_t kernel_mismatch(L const& l, R const& r) noexcept
+{
+  return mismatch_bytes(&l, &r, sizeof l)
+                                     / sizeof(remove_all_extents_t<L>);
+}
 } // impl
 
+// operator==(l,r) bounded_arrays of equal extent and equal elements
+//
+template <typename L, typename R>
+  requires equality_comparable_with<L,R>
+constexpr bool operator==(bounded_array<L> l, bounded_array<R> r)
+{
+  if (l.size() != r.size())
+    return false;
+  if constexpr (bytewise_comparable<L[1],R[1]>)
+    if (! std::is_constant_evaluated())
+    {
+      auto n = l.size_bytes();
+      return impl::kernels_dispatched && n >= kernel_min_bytes
+           ? impl::mismatch_bytes(l.data(), r.data(), n) == n
+           : n == 0 || std::memcmp(l.data(), r.data(), n) == 0;
+    }
+  for (std::size_t i = 0; i != l.flat_count(); ++i)
+    if (l.flat(i) != r.flat(i))
+      return false;
+  return true;
+}
+
+// operator<=>(l,r) lexicographic over the flattened elements of bounded
+//                  arrays, then by extent
+//
+template <typename L, typename R>
+  requires three_way_comparable_with<L,R>
+constexpr auto operator<=>(bounded_array<L> l, bounded_array<R> r)
+  -> compare_three_way_result_t<L,R>
+{
+  auto n = l.size() < r.size() ? l.flat_count() : r.flat_count();
+  std::size_t i = 0;
+  if constexpr (bytewise_comparable<L[1],R[1]>)
+    if (! std::is_constant_evaluated() && n != 0)
+    {
+      using E = remove_all_extents_t<L>;
+      auto b = n * sizeof(E);
+      i = (b >= kernel_min_bytes ? impl::mismatch_bytes(l.data(), r.data(), b)
+                     : impl::mismatch_words(l.data(), r.data(), b))
+        / sizeof(E);
+    }
+  for (; i != n; ++i)
+    if (auto c = std::compare_three_way{}(l.flat(i), r.flat(i)); c != 0)
+      return c;
+  return l.size() <=> r.size();
+}
+
 // compare_three_way
 //   A version of std::compare_three_way extended to compare arrays
 //
@@ -189,6 +263,15 @@ struct compare_three_way
       return std::compare_three_way{}((L&&)l, (R&&)r);
     else
     {
+      if constexpr (impl::kernel_comparable<L,R>)
+        if (! std::is_constant_evaluated())
+        {
+          auto i = impl::kernel_mismatch((L&&)l, (R&&)r);
+          if (i == flat_size<L>)
+            return compare_three_way_result_t<L,R>::equivalent;
+          return std::compare_three_way{}(flat_index((L&&)l,i),
+                                          flat_index((R&&)r,i));
+        }
       for (int i = 0; i != flat_size<L>; ++i)
       {
         auto c = std::compare_three_way{}(flat_index((L&&)l,i),
@@ -225,6 +308,9 @@ struct equal_to
       return (L&&)l == (R&&)r;
     else
     {
+      if constexpr (bytewise_comparable<L,R>)
+        if (! std::is_constant_evaluated())
+          return impl::equal_bytes_n<sizeof(L)>(&l, &r);
       for (int i = 0; i != flat_size<L>; ++i)
         if ( flat_index((L&&)l,i) != flat_index((R&&)r,i) )
           return false;
@@ -297,6 +383,13 @@ struct less
     }
     else
     {
+      if constexpr (impl::kernel_comparable<L,R>)
+        if (! std::is_constant_evaluated())
+        {
+          auto i = impl::kernel_mismatch((L&&)l, (R&&)r);
+          return i != flat_size<L>
+              && flat_index((L&&)l,i) < flat_index((R&&)r,i);
+        }
       for (int i = 0; i != flat_size<L>; ++i)
         if ( flat_index((L&&)l,i) != flat_index((R&&)r,i) )
           return flat_index((L&&)l,i) < flat_index((R&&)r,i);
@@ -0,0 +1,180 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_FAM_HPP
+#define LML_C_ARRAY_FAM_HPP
+/*
+  c_array_fam.hpp
+  ===============
+
+  fam<Header,T> an owning handle to a Header followed by a runtime-sized
+  payload of T elements, in a single allocation; the C 'flexible array
+  member' pattern, struct { Header h; T payload[]; } (or T payload[0]
+  in old-style C, see tests/test_zero_size_array.cpp).
+
+  Depends on <memory>, <new>, <span>, <utility> and "c_array_support.hpp"
+
+  Usage
+  =====
+    struct msg_header { int type; int flags; };
+
+    auto m = lml::fam<msg_header, float>::make(64, 1, 0);
+    m->type;                          // header access
+    std::span<float> p = m.payload(); // payload access, size 64
+    float (&f)[8] = m.as<8>();        // static-size view of payload
+
+  This saves the second allocation and the pointer chase of a Header
+  plus std::vector<T> and keeps header and payload in adjacent lines.
+
+  The payload starts at the first offset after the header suitably
+  aligned for T and the allocation is aligned for both Header and T.
+  make(n,args...) constructs the header from args... and value-inits
+  the n payload elements; the handle destroys both.
+
+  as<N>() returns a T(&)[N] view of the first N payload elements so that
+  static-size lml algorithms apply; N <= size() is a precondition, not
+  checked (as for flat_index). N == 0 gives a zero-size array view.
+*/
+
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+#include "c_array_support.hpp"
+
+#include "namespace.hpp"
+
+// fam<Header,T> owning handle to a Header plus a T[n] payload
+//
+template <typename Header, typename T>
+  requires (std::is_object_v<Header> && ! is_array_v<Header>
+         && std::is_object_v<T> && ! std::is_unbounded_array_v<T>
+         && ! std::is_const_v<Header> && ! std::is_const_v<T>)
+class fam
+{
+ public:
+  using header_type = Header;
+  using element_type = T;
+
+  static constexpr std::size_t alignment = alignof(Header) > alignof(T)
+                                         ? alignof(Header) : alignof(T);
+  static constexpr std::size_t payload_offset = (sizeof(Header)
+                              + alignof(T) - 1) / alignof(T) * alignof(T);
+
+  // make(n,args...) allocates, constructs the header from args... and
+  //                 value-initializes n payload elements
+  //
+  template <typename... Args>
+    requires std::is_constructible_v<Header, Args&&...>
+  static fam make(std::size_t n, Args&&... args)
+  {
+    void* mem = ::operator new(payload_offset + n * sizeof(T),
+                               std::align_val_t{alignment});
+    struct deallocate_on_throw {
+      void* mem;
+      ~deallocate_on_throw() {
+        if (mem) ::operator delete(mem, std::align_val_t{alignment});
+      }
+    } guard{mem};
+
+    Header* h = ::new (mem) Header((Args&&)args...);
+    try {
+      std::uninitialized_value_construct_n(payload_storage(mem), n);
+    }
+    catch (...) {
+      std::destroy_at(h);
+      throw;
+    }
+    guard.mem = nullptr;
+    return fam(mem, n);
+  }
+
+  fam(fam&& o) noexcept : mem(o.mem), n(o.n) { o.mem = nullptr; }
+
+  fam& operator=(fam&& o) noexcept
+  {
+    if (this != &o) {
+      release();
+      mem = std::exchange(o.mem, nullptr);
+      n = o.n;
+    }
+    return *this;
+  }
+
+  ~fam() { release(); }
+
+  explicit operator bool() const noexcept { return mem != nullptr; }
+
+  Header& header() noexcept { return *header_ptr(); }
+  Header const& header() const noexcept { return *header_ptr(); }
+
+  Header* operator->() noexcept { return header_ptr(); }
+  Header const* operator->() const noexcept { return header_ptr(); }
+
+  std::span<T> payload() noexcept { return {payload_ptr(mem), n}; }
+  std::span<T const> payload() const noexcept
+  {
+    return {payload_ptr(mem), n};
+  }
+
+  std::size_t size() const noexcept { return n; }
+
+  std::size_t size_bytes() const noexcept
+  {
+    return payload_offset + n * sizeof(T);
+  }
+
+  // as<N>() returns a reference to the first N payload elements as T[N]
+  //
+  template <std::size_t N>
+  auto& as() noexcept
+  {
+    using A = c_array_t<T,int(N)>;
+    return *std::launder(reinterpret_cast<A*>(payload_ptr(mem)));
+  }
+
+  template <std::size_t N>
+  auto& as() const noexcept
+  {
+    using A = c_array_t<T,int(N)> const;
+    return *std::launder(reinterpret_cast<A*>(payload_ptr(mem)));
+  }
+
+ private:
+  void* mem;
+  std::size_t n;
+
+  fam(void* m, std::size_t s) noexcept : mem(m), n(s) {}
+
+  static T* payload_storage(void* m) noexcept
+  {
+    return reinterpret_cast<T*>(static_cast<unsigned char*>(m)
+                                + payload_offset);
+  }
+
+  static T* payload_ptr(void* m) noexcept
+  {
+    return std::launder(payload_storage(m));
+  }
+
+  Header* header_ptr() const noexcept
+  {
+    return std::launder(static_cast<Header*>(mem));
+  }
+
+  void release() noexcept
+  {
+    if (mem) {
+      std::destroy_n(payload_ptr(mem), n);
+      std::destroy_at(header_ptr());
+      ::operator delete(mem, std::align_val_t{alignment});
+    }
+  }
+};
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_FAM_HPP
@@ -0,0 +1,210 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_FIXED_STRING_HPP
+#define LML_C_ARRAY_FIXED_STRING_HPP
+/*
+  c_array_fixed_string.hpp
+  ========================
+
+  A string literal wrapper usable as a class-type template argument,
+  with comparison and hashing a word at a time in constant evaluation.
+
+  Depends on <bit>, <compare>, <cstdint>, <string_view>,
+  "c_array_compare.hpp" and "c_array_hash.hpp"
+
+  Class template:
+
+    lml::fixed_string<N>  structural type holding the N chars of a char[N]
+                          string literal, its terminating NUL included
+
+  Functions:
+
+    l == r, l <=> r       compare fixed_strings, or with string literals
+    l + r                 concatenation, a fixed_string<N+M-1>
+    lml::hash{}(s)        hashes s by value (c_array_hash.hpp)
+
+  Usage
+  =====
+    template <lml::fixed_string name> struct metric {};
+    metric<"requests.total"> m;
+
+    constexpr lml::fixed_string key = "field";
+    static_assert( key + ".id" == "field.id" );
+    static_assert( key < "fields" && key.size() == 5 );
+    constexpr auto h = lml::hash{}(key);
+
+  A fixed_string<N> is N-1 chars long, as its literal; the chars array is
+  padded with NULs to a multiple of 8, so that it can be read as 64-bit
+  words by a single std::bit_cast. Equality compares words, N/8 steps, not
+  N char comparisons; fixed_strings of different N are unequal with no
+  comparison at all. Ordering finds the first differing word, then the
+  first differing char in it, compared by lml::compare_three_way, i.e. as
+  char, as for C arrays; a proper prefix orders first.
+
+  lml::hash hashes the padded chars (all bytes are values), so it's a
+  constexpr hash that's equal at runtime; fixed_strings with equal chars
+  hash equal.
+*/
+
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <string_view>
+
+#include "c_array_compare.hpp"
+#include "c_array_hash.hpp"
+
+#include "namespace.hpp"
+
+namespace impl {
+
+// fixed_words<N> the number of 64-bit words that hold N chars
+//
+template <std::size_t N>
+inline constexpr std::size_t fixed_words = (N + 7) / 8;
+
+template <std::size_t W>
+struct word_array { std::uint64_t w[W]; };
+
+// first_byte(x) the index, in memory order, of the first nonzero byte
+//               of a word x != 0
+//
+constexpr std::size_t first_byte(std::uint64_t x) noexcept
+{
+  if constexpr (std::endian::native == std::endian::little)
+    return std::countr_zero(x) / 8;
+  else
+    return std::countl_zero(x) / 8;
+}
+
+} // impl
+
+// fixed_string<N> the N chars of a string literal, NUL terminated,
+//                 as a structural type for template arguments
+//
+template <std::size_t N>
+  requires (N != 0)
+struct fixed_string
+{
+  static constexpr std::size_t words = impl::fixed_words<N>;
+
+  char chars[words * 8] {};
+
+  constexpr fixed_string() noexcept = default;
+
+  constexpr fixed_string(char const (&s)[N]) noexcept
+  {
+    for (std::size_t i = 0; i != N - 1; ++i)
+      chars[i] = s[i];
+  }
+
+  // size() the number of chars, not counting the terminating NUL
+  static constexpr std::size_t size() noexcept { return N - 1; }
+  static constexpr bool empty() noexcept { return N == 1; }
+
+  constexpr char const* data() const noexcept { return chars; }
+  constexpr char const* c_str() const noexcept { return chars; }
+  constexpr char const* begin() const noexcept { return chars; }
+  constexpr char const* end() const noexcept { return chars + N - 1; }
+  constexpr char operator[](std::size_t i) const noexcept
+  {
+    return chars[i];
+  }
+
+  constexpr std::string_view view() const noexcept { return {chars, N - 1}; }
+  constexpr operator std::string_view() const noexcept { return view(); }
+
+  // as_words() the chars as 64-bit words, by one bit_cast
+  constexpr impl::word_array<words> as_words() const noexcept
+  {
+    return std::bit_cast<impl::word_array<words>>(*this);
+  }
+};
+
+template <std::size_t N>
+fixed_string(char const (&)[N]) -> fixed_string<N>;
+
+// l == r fixed_strings of equal size and chars, compared by words
+//
+template <std::size_t N, std::size_t M>
+constexpr bool operator==(fixed_string<N> const& l,
+                          fixed_string<M> const& r) noexcept
+{
+  if constexpr (N != M)
+    return false;
+  else {
+    auto a = l.as_words(), b = r.as_words();
+    for (std::size_t i = 0; i != fixed_string<N>::words; ++i)
+      if (a.w[i] != b.w[i])
+        return false;
+    return true;
+  }
+}
+
+template <std::size_t N, std::size_t M>
+constexpr bool operator==(fixed_string<N> const& l,
+                          char const (&r)[M]) noexcept
+{
+  return l == fixed_string<M>(r);
+}
+
+// l <=> r lexicographic order by lml::compare_three_way of the first
+//         differing chars, found by words, then by size
+//
+template <std::size_t N, std::size_t M>
+constexpr std::strong_ordering operator<=>(fixed_string<N> const& l,
+                                           fixed_string<M> const& r) noexcept
+{
+  constexpr std::size_t n = (N < M ? N : M) - 1;
+  auto a = l.as_words(), b = r.as_words();
+  for (std::size_t i = 0; i != impl::fixed_words<n>; ++i)
+    if (auto x = a.w[i] ^ b.w[i]) {
+      std::size_t j = 8 * i + impl::first_byte(x);
+      if (j >= n)
+        break;
+      return lml::compare_three_way{}(l.chars[j], r.chars[j]);
+    }
+  return N <=> M;
+}
+
+template <std::size_t N, std::size_t M>
+constexpr std::strong_ordering operator<=>(fixed_string<N> const& l,
+                                           char const (&r)[M]) noexcept
+{
+  return l <=> fixed_string<M>(r);
+}
+
+// l + r concatenation of fixed_strings or string literals
+//
+template <std::size_t N, std::size_t M>
+constexpr fixed_string<N + M - 1> operator+(fixed_string<N> const& l,
+                                            fixed_string<M> const& r) noexcept
+{
+  fixed_string<N + M - 1> s;
+  for (std::size_t i = 0; i != N - 1; ++i)
+    s.chars[i] = l.chars[i];
+  for (std::size_t i = 0; i != M - 1; ++i)
+    s.chars[N - 1 + i] = r.chars[i];
+  return s;
+}
+
+template <std::size_t N, std::size_t M>
+constexpr fixed_string<N + M - 1> operator+(fixed_string<N> const& l,
+                                            char const (&r)[M]) noexcept
+{
+  return l + fixed_string<M>(r);
+}
+
+template <std::size_t N, std::size_t M>
+constexpr fixed_string<N + M - 1> operator+(char const (&l)[N],
+                                            fixed_string<M> const& r) noexcept
+{
+  return fixed_string<N>(l) + r;
+}
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_FIXED_STRING_HPP
@@ -0,0 +1,463 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_HALF_HPP
+#define LML_C_ARRAY_HALF_HPP
+/*
+  c_array_half.hpp
+  ================
+
+  Conversion of C arrays between float and 16-bit floating point
+  storage, IEEE binary16 or bfloat16, with round to nearest even.
+
+  Depends on <bit>, <cstdint>, <cstring>, "c_array_support.hpp"
+  and "c_array_kernels.hpp" (plus <stdfloat> if it has std::bfloat16_t)
+
+  Types:
+
+    lml::half_format     binary16 or bfloat16
+
+  Concepts:
+
+    lml::half_storage<E,F>  E stores 16-bit floats of format F:
+                            std::uint16_t bits, or the compiler's
+                            _Float16 (binary16) or std::bfloat16_t
+
+  Functions:
+
+    lml::convert<F>(d,s)   converts the elements of s to d, either
+                           half_storage to float or float to half_storage
+    lml::convert(d,s)      the same; format binary16 for uint16_t,
+                           else that of the _Float16 or bfloat16_t type
+
+  Usage
+  =====
+    std::uint16_t w[64][64];             // binary16 weights, as bits
+    float f[64][64];
+    lml::convert(f, w);                  // widen binary16 to float
+    lml::convert(w, f);                  // narrow float to binary16
+    lml::convert<lml::half_format::bfloat16>(f, w);   // bfloat16 bits
+
+  The arrays must have the same extents, checked by the type system.
+  Narrowing rounds to nearest even, overflowing to infinity; binary16
+  subnormals are converted exactly. NaNs stay NaN, made quiet, keeping
+  the leading payload bits (as the F16C instructions do).
+
+  Kernels
+  =======
+  At runtime, whole arrays are converted by kernels selected by the
+  active kernel tier of c_array_kernels.hpp: binary16 by the F16C
+  instructions at the avx2 tier (on CPUs that have F16C) and the
+  AVX-512F vcvtph2ps and vcvtps2ph at the avx512 tier, 8 or 16 lanes at
+  a time. bfloat16, a shift one way and a rounding add the other, is a
+  portable loop compiled for each tier for the compiler to vectorize.
+  Other tiers, and constant evaluation, use the portable bit manipulation
+  of impl::half_to_float and float_to_half, which gives the same results.
+  The kernels are inline unless LML_KERNELS_LIB is defined, in which case
+  they're compiled once, in the c_array_kernels library.
+
+  AVX-512 BF16 vcvtneps2bf16 isn't used, as it flushes subnormals, so
+  its results would depend on the tier.
+*/
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__STDCPP_BFLOAT16_T__) && __has_include(<stdfloat>)
+#include <stdfloat>
+#define LML_HAS_BFLOAT16_T 1
+#endif
+
+#include "c_array_support.hpp"
+#include "c_array_kernels.hpp"
+
+// LML_KERNEL as in c_array_kernels.hpp; out of line in the library
+//
+#if ! defined(LML_KERNELS_LIB)
+#define LML_KERNEL inline
+#define LML_KERNEL_DEFINE
+#elif defined(LML_KERNELS_SOURCE)
+#define LML_KERNEL
+#define LML_KERNEL_DEFINE
+#else
+#define LML_KERNEL
+#endif
+
+#include "namespace.hpp"
+
+enum class half_format : std::uint8_t { binary16, bfloat16 };
+
+namespace impl {
+
+template <typename E>
+inline constexpr bool is_float16 = false;
+#if defined(__FLT16_MANT_DIG__)
+template <>
+inline constexpr bool is_float16<_Float16> = true;
+#endif
+
+template <typename E>
+inline constexpr bool is_bfloat16 = false;
+#if defined(LML_HAS_BFLOAT16_T)
+template <>
+inline constexpr bool is_bfloat16<std::bfloat16_t> = true;
+#endif
+
+} // impl
+
+// half_storage<E,F> concept: E stores 16-bit floats of format F
+//
+template <typename E, half_format F, typename U = std::remove_cv_t<E>>
+concept half_storage = ! std::is_volatile_v<E>
+                    && (std::is_same_v<U, std::uint16_t>
+                     || (F == half_format::binary16 && impl::is_float16<U>)
+                     || (F == half_format::bfloat16 && impl::is_bfloat16<U>));
+
+namespace impl {
+
+// half_format_of<E> the format of half_storage element E; binary16 for
+//                   uint16_t bits
+//
+template <typename E>
+inline constexpr half_format half_format_of
+         = is_bfloat16<std::remove_cv_t<E>> ? half_format::bfloat16
+                                            : half_format::binary16;
+
+// half_to_float(h) binary16 bits h as a float, exactly
+//
+constexpr float half_to_float(std::uint16_t h) noexcept
+{
+  std::uint32_t o = std::uint32_t(h & 0x7fffu) << 13;
+  std::uint32_t e = o & 0x0f800000u;
+  o += (127 - 15) << 23;
+  if (e == 0x0f800000u) {               // inf or nan
+    o += (128 - 16) << 23;
+    if (o & 0x7fffffu)
+      o |= 0x400000u;
+  }
+  else if (e == 0) {                    // zero or subnormal
+    o += 1 << 23;
+    o = std::bit_cast<std::uint32_t>(std::bit_cast<float>(o)
+                                   - std::bit_cast<float>(113u << 23));
+  }
+  return std::bit_cast<float>(o | std::uint32_t(h & 0x8000u) << 16);
+}
+
+// float_to_half(x) x as binary16 bits, rounded to nearest even
+//
+constexpr std::uint16_t float_to_half(float x) noexcept
+{
+  std::uint32_t f = std::bit_cast<std::uint32_t>(x);
+  std::uint32_t sign = f & 0x80000000u;
+  f ^= sign;
+  std::uint32_t o;
+  if (f >= (127u + 16) << 23)           // overflow, inf or nan
+    o = f > 0x7f800000u ? 0x7e00u | (f >> 13 & 0x3ffu) : 0x7c00u;
+  else if (f < 113u << 23) {            // subnormal or zero result
+    constexpr std::uint32_t magic = (127u - 15 + 23 - 10 + 1) << 23;
+    o = std::bit_cast<std::uint32_t>(std::bit_cast<float>(f)
+                                   + std::bit_cast<float>(magic)) - magic;
+  }
+  else {
+    std::uint32_t odd = f >> 13 & 1;
+    f += (std::uint32_t(15 - 127) << 23) + 0xfffu + odd;
+    o = f >> 13;
+  }
+  return static_cast<std::uint16_t>(o | sign >> 16);
+}
+
+// bfloat16_to_float(b) bfloat16 bits b as a float, exactly
+//
+constexpr float bfloat16_to_float(std::uint16_t b) noexcept
+{
+  return std::bit_cast<float>(std::uint32_t{b} << 16);
+}
+
+// float_to_bfloat16(x) x as bfloat16 bits, rounded to nearest even
+//
+constexpr std::uint16_t float_to_bfloat16(float x) noexcept
+{
+  std::uint32_t f = std::bit_cast<std::uint32_t>(x);
+  if ((f & 0x7fffffffu) > 0x7f800000u)
+    return static_cast<std::uint16_t>(f >> 16 | 0x40u);
+  return static_cast<std::uint16_t>((f + 0x7fffu + (f >> 16 & 1)) >> 16);
+}
+
+// widen_loop(d,s,i,n), narrow_loop(d,s,i,n) convert elements [i,n) by
+//  cvt; halves accessed by memcpy, as the bytes of any half_storage
+//
+template <auto cvt>
+inline void widen_loop(float* d, void const* s,
+                       std::size_t i, std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char const*>(s);
+  for (; i != n; ++i) {
+    std::uint16_t h;
+    std::memcpy(&h, p + 2 * i, 2);
+    d[i] = cvt(h);
+  }
+}
+
+template <auto cvt>
+inline void narrow_loop(void* d, float const* s,
+                        std::size_t i, std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char*>(d);
+  for (; i != n; ++i) {
+    std::uint16_t h = cvt(s[i]);
+    std::memcpy(p + 2 * i, &h, 2);
+  }
+}
+
+// half_table conversion kernels of n elements, for one tier
+//
+struct half_table
+{
+  void (*half_to_float)(float*, void const*, std::size_t) noexcept;
+  void (*float_to_half)(void*, float const*, std::size_t) noexcept;
+  void (*bfloat16_to_float)(float*, void const*, std::size_t) noexcept;
+  void (*float_to_bfloat16)(void*, float const*, std::size_t) noexcept;
+};
+
+LML_KERNEL void half_to_float_scalar(float* d, void const* s,
+                                     std::size_t n) noexcept;
+LML_KERNEL void float_to_half_scalar(void* d, float const* s,
+                                     std::size_t n) noexcept;
+LML_KERNEL void bfloat16_to_float_scalar(float* d, void const* s,
+                                         std::size_t n) noexcept;
+LML_KERNEL void float_to_bfloat16_scalar(void* d, float const* s,
+                                         std::size_t n) noexcept;
+#if defined(LML_KERNELS_X86)
+__attribute__((target("avx2,f16c")))
+LML_KERNEL void half_to_float_f16c(float* d, void const* s,
+                                   std::size_t n) noexcept;
+__attribute__((target("avx2,f16c")))
+LML_KERNEL void float_to_half_f16c(void* d, float const* s,
+                                   std::size_t n) noexcept;
+__attribute__((target("avx2")))
+LML_KERNEL void bfloat16_to_float_avx2(float* d, void const* s,
+                                       std::size_t n) noexcept;
+__attribute__((target("avx2")))
+LML_KERNEL void float_to_bfloat16_avx2(void* d, float const* s,
+                                       std::size_t n) noexcept;
+__attribute__((target("avx512f")))
+LML_KERNEL void half_to_float_avx512(float* d, void const* s,
+                                     std::size_t n) noexcept;
+__attribute__((target("avx512f")))
+LML_KERNEL void float_to_half_avx512(void* d, float const* s,
+                                     std::size_t n) noexcept;
+__attribute__((target("avx512f")))
+LML_KERNEL void bfloat16_to_float_avx512(float* d, void const* s,
+                                         std::size_t n) noexcept;
+__attribute__((target("avx512f")))
+LML_KERNEL void float_to_bfloat16_avx512(void* d, float const* s,
+                                         std::size_t n) noexcept;
+#endif
+
+#if defined(LML_KERNEL_DEFINE)
+
+LML_KERNEL void half_to_float_scalar(float* d, void const* s,
+                                     std::size_t n) noexcept
+{
+  widen_loop<half_to_float>(d, s, 0, n);
+}
+
+LML_KERNEL void float_to_half_scalar(void* d, float const* s,
+                                     std::size_t n) noexcept
+{
+  narrow_loop<float_to_half>(d, s, 0, n);
+}
+
+LML_KERNEL void bfloat16_to_float_scalar(float* d, void const* s,
+                                         std::size_t n) noexcept
+{
+  widen_loop<bfloat16_to_float>(d, s, 0, n);
+}
+
+LML_KERNEL void float_to_bfloat16_scalar(void* d, float const* s,
+                                         std::size_t n) noexcept
+{
+  narrow_loop<float_to_bfloat16>(d, s, 0, n);
+}
+
+#if defined(LML_KERNELS_X86)
+
+__attribute__((target("avx2,f16c")))
+LML_KERNEL void half_to_float_f16c(float* d, void const* s,
+                                   std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char const*>(s);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(d + i, _mm256_cvtph_ps(_mm_loadu_si128(
+                          reinterpret_cast<__m128i const*>(p + 2 * i))));
+  widen_loop<half_to_float>(d, s, i, n);
+}
+
+__attribute__((target("avx2,f16c")))
+LML_KERNEL void float_to_half_f16c(void* d, float const* s,
+                                   std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char*>(d);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 2 * i),
+                     _mm256_cvtps_ph(_mm256_loadu_ps(s + i),
+                                     _MM_FROUND_TO_NEAREST_INT));
+  narrow_loop<float_to_half>(d, s, i, n);
+}
+
+__attribute__((target("avx2")))
+LML_KERNEL void bfloat16_to_float_avx2(float* d, void const* s,
+                                       std::size_t n) noexcept
+{
+  widen_loop<bfloat16_to_float>(d, s, 0, n);
+}
+
+__attribute__((target("avx2")))
+LML_KERNEL void float_to_bfloat16_avx2(void* d, float const* s,
+                                       std::size_t n) noexcept
+{
+  narrow_loop<float_to_bfloat16>(d, s, 0, n);
+}
+
+__attribute__((target("avx512f")))
+LML_KERNEL void half_to_float_avx512(float* d, void const* s,
+                                     std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char const*>(s);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(d + i, _mm512_maskz_cvtph_ps(0xffff,
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + 2 * i))));
+  widen_loop<half_to_float>(d, s, i, n);
+}
+
+__attribute__((target("avx512f")))
+LML_KERNEL void float_to_half_avx512(void* d, float const* s,
+                                     std::size_t n) noexcept
+{
+  auto p = static_cast<unsigned char*>(d);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 2 * i),
+                        _mm512_maskz_cvtps_ph(0xffff, _mm512_loadu_ps(s + i),
+                                              _MM_FROUND_TO_NEAREST_INT));
+  narrow_loop<float_to_half>(d, s, i, n);
+}
+
+__attribute__((target("avx512f")))
+LML_KERNEL void bfloat16_to_float_avx512(float* d, void const* s,
+                                         std::size_t n) noexcept
+{
+  widen_loop<bfloat16_to_float>(d, s, 0, n);
+}
+
+__attribute__((target("avx512f")))
+LML_KERNEL void float_to_bfloat16_avx512(void* d, float const* s,
+                                         std::size_t n) noexcept
+{
+  narrow_loop<float_to_bfloat16>(d, s, 0, n);
+}
+
+#endif // LML_KERNELS_X86
+
+#endif // LML_KERNEL_DEFINE
+
+inline constexpr half_table half_tables[] = {
+  {half_to_float_scalar, float_to_half_scalar,
+   bfloat16_to_float_scalar, float_to_bfloat16_scalar},
+#if defined(LML_KERNELS_X86)
+  {half_to_float_f16c, float_to_half_f16c,
+   bfloat16_to_float_avx2, float_to_bfloat16_avx2},
+  {half_to_float_avx512, float_to_half_avx512,
+   bfloat16_to_float_avx512, float_to_bfloat16_avx512},
+#endif
+};
+
+// half_kernels() the half_table of the active kernel tier; the avx2
+//                tier needs F16C too, else it's the scalar table
+//
+inline half_table const& half_kernels() noexcept
+{
+#if defined(LML_KERNELS_X86)
+  switch (active_kernel_tier()) {
+    case kernel_tier::avx2: {
+      static bool const f16c = (__builtin_cpu_init(),
+                                __builtin_cpu_supports("f16c") != 0);
+      return half_tables[f16c ? 1 : 0];
+    }
+    case kernel_tier::avx512: return half_tables[2];
+    default: break;
+  }
+#endif
+  return half_tables[0];
+}
+
+} // impl
+
+// convert<F>(d,s) converts half_storage elements of s to float elements
+//                 of d, or float elements of s to half_storage of d
+//
+template <half_format F, c_array D, c_array S,
+          typename ED = remove_all_extents_t<D>,
+          typename ES = remove_all_extents_t<S>>
+  requires same_extents<D, std::remove_cv_t<S>>
+        && ((std::is_same_v<ED, float> && half_storage<ES, F>)
+         || (half_storage<ED, F> && std::is_same_v<std::remove_cv_t<ES>,
+                                                   float>))
+        && (! std::is_const_v<ED>) && (! std::is_volatile_v<ES>)
+constexpr D& convert(D& d, S const& s) noexcept
+{
+  constexpr bool widen = std::is_same_v<ED, float>;
+  constexpr auto n = static_cast<std::size_t>(flat_size<D>);
+  if (std::is_constant_evaluated()) {
+    for (std::size_t i = 0; i != n; ++i)
+      if constexpr (widen) {
+        auto h = std::bit_cast<std::uint16_t>(flat_index(s, i));
+        flat_index(d, i) = F == half_format::binary16
+                         ? impl::half_to_float(h)
+                         : impl::bfloat16_to_float(h);
+      } else {
+        float x = flat_index(s, i);
+        flat_index(d, i) = std::bit_cast<ED>(F == half_format::binary16
+                                           ? impl::float_to_half(x)
+                                           : impl::float_to_bfloat16(x));
+      }
+    return d;
+  }
+  if constexpr (n != 0) {
+    auto& k = impl::half_kernels();
+    if constexpr (widen)
+      (F == half_format::binary16 ? k.half_to_float : k.bfloat16_to_float)(
+        reinterpret_cast<float*>(&d), &s, n);
+    else
+      (F == half_format::binary16 ? k.float_to_half : k.float_to_bfloat16)(
+        &d, reinterpret_cast<float const*>(&s), n);
+  }
+  return d;
+}
+
+// convert(d,s) convert<F>(d,s), F the format of the half_storage type
+//
+template <c_array D, c_array S,
+          typename EH = std::conditional_t<
+            std::is_same_v<std::remove_cv_t<remove_all_extents_t<S>>, float>,
+                           remove_all_extents_t<D>,
+                           remove_all_extents_t<S>>>
+  requires requires (D& d, S const& s) {
+    convert<impl::half_format_of<EH>>(d, s); }
+constexpr D& convert(D& d, S const& s) noexcept
+{
+  return convert<impl::half_format_of<EH>>(d, s);
+}
+
+#include "namespace.hpp"
+
+#undef LML_KERNEL
+#undef LML_KERNEL_DEFINE
+
+#endif // LML_C_ARRAY_HALF_HPP
@@ -0,0 +1,259 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_HASH_HPP
+#define LML_C_ARRAY_HASH_HPP
+/*
+  c_array_hash.hpp
+  ================
+
+  A hash functor extended to support C arrays, hashing array values,
+  not array ids, so it's consistent with lml::equal_to.
+
+  Depends on <bit>, <cstdint> and "c_array_support.hpp"
+
+  Concepts:
+
+    lml::hashable<T>   T is hashable by value representation
+
+  Functors:
+
+    lml::hash          c.f. std::hash, for hashable types and C arrays
+
+  Functions:
+
+    lml::impl::hash_bytes(p,n,seed)  64-bit hash of n bytes at p
+    lml::impl::hash_combine(l,r)     combine two 64-bit hash values
+
+  Usage
+  =====
+    constexpr char hello[] = "hello";
+    static_assert( lml::hash{}(hello) == lml::hash{}("hello") );
+
+    int a[2][2] {{0,1},{2,3}};
+    auto h = lml::hash{}(a);
+
+  Hashable types are trivially copyable types with unique object
+  representations, i.e. equal values have equal bytes, plus float and
+  double, where -0.0 is normalized to +0.0 before hashing.
+  Arrays of hashable element type are hashable, as are bounded_arrays
+  (c_array_bounded.hpp), hashed equal to the C array of their extents.
+  There's no fallback to std::hash (that'd drag in <functional>).
+
+  The runtime path is hash_bytes_n<sizeof(T)>, one instantiation per
+  byte count, shared by all types of that size. With LML_KERNELS_LIB
+  defined (the c_array_kernels library linked) it calls the same
+  hash_bytes, compiled in the library.
+
+  Hash values are the same in constant evaluation as at runtime, so
+  a constexpr hash can be compared with a runtime hash. The hash is not
+  a cryptographic hash and its values may change between releases.
+*/
+
+#include <bit>
+#include <cstdint>
+
+#include "c_array_support.hpp"
+
+#include "namespace.hpp"
+
+// hashable<T> concept: T is a trivially copyable type with unique object
+//  representations, or floating point, or an array of such element type
+//
+template <typename T, typename E = remove_all_extents_t<
+                                   std::remove_cvref_t<T>>>
+concept hashable = std::is_trivially_copyable_v<E>
+   && (std::has_unique_object_representations_v<E>
+    || (std::is_floating_point_v<E> && (sizeof(E)==4 || sizeof(E)==8)))
+   && (! c_array<T> || c_array_unpadded<T>)
+   && ! bounded_array_type<T>;
+
+template <typename T> using is_hashable
+         = std::bool_constant< hashable<T>>;
+
+namespace impl {
+
+inline constexpr std::uint64_t hash_k = 0x9e3779b97f4a7c15;
+
+// hash_fmix(h) 64-bit finalization mix (c.f. murmur3 fmix64)
+//
+constexpr std::uint64_t hash_fmix(std::uint64_t h) noexcept
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccd;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53;
+  h ^= h >> 33;
+  return h;
+}
+
+// hash_word(h,w) accumulates a 64-bit word w into hash state h
+//
+constexpr std::uint64_t hash_word(std::uint64_t h, std::uint64_t w)
+  noexcept
+{
+  h = (h ^ w) * hash_k;
+  return h ^ (h >> 29);
+}
+
+// load_le64(p,n) loads n <= 8 bytes as a little-endian integer
+//  (compiles to a plain load on little-endian targets, for n == 8)
+//
+constexpr std::uint64_t load_le64(unsigned char const* p, int n = 8)
+  noexcept
+{
+  std::uint64_t w = 0;
+  for (int i = 0; i != n; ++i)
+    w |= std::uint64_t{p[i]} << 8*i;
+  return w;
+}
+
+// hash_bytes(p,n,seed) hashes n bytes at p, eight bytes at a time
+//
+constexpr std::uint64_t hash_bytes(unsigned char const* p,
+                                   std::size_t n,
+                                   std::uint64_t seed = 0) noexcept
+{
+  std::uint64_t h = seed ^ (n * hash_k);
+  for (; n >= 8; n -= 8, p += 8)
+    h = hash_word(h, load_le64(p));
+  if (n != 0)
+    h = hash_word(h, load_le64(p, static_cast<int>(n)));
+  return hash_fmix(h);
+}
+
+// hash_combine(l,r) combines two hash values, order dependent
+//
+constexpr std::uint64_t hash_combine(std::uint64_t l, std::uint64_t r)
+  noexcept
+{
+  return hash_fmix(hash_word(hash_word(hash_k, l), r));
+}
+
+// float_bits(f) bit pattern of f as an unsigned integer, -0.0 -> +0.0
+//
+template <typename F>
+constexpr auto float_bits(F f) noexcept
+{
+  if constexpr (sizeof(F) == 8)
+    return std::bit_cast<std::uint64_t>(f == 0 ? F{} : f);
+  else
+    return std::bit_cast<std::uint32_t>(f == 0 ? F{} : f);
+}
+
+template <std::size_t N>
+struct byte_array { unsigned char bytes[N]; };
+
+#if defined(LML_KERNELS_LIB)
+// hash_bytes_lib(p,n,seed) hash_bytes compiled in the c_array_kernels
+//                          library, for the runtime path
+//
+std::uint64_t hash_bytes_lib(unsigned char const* p, std::size_t n,
+                             std::uint64_t seed = 0) noexcept;
+#endif
+
+// hash_bytes_n<B>(p) runtime hash_bytes of B bytes at p; canonical,
+//                    keyed by byte count
+//
+template <std::size_t B>
+inline std::uint64_t hash_bytes_n(void const* p) noexcept
+{
+#if defined(LML_KERNELS_LIB)
+  return hash_bytes_lib(static_cast<unsigned char const*>(p), B);
+#else
+  return hash_bytes(static_cast<unsigned char const*>(p), B);
+#endif
+}
+
+// hash_elements(b) hash_bytes of the elements of bounded_array b,
+//                  streamed a byte at a time, for constant evaluation
+//
+template <typename T>
+constexpr std::uint64_t hash_elements(bounded_array<T> b) noexcept
+{
+  using E = remove_all_extents_t<T>;
+  std::uint64_t h = b.size_bytes() * hash_k;
+  std::uint64_t w = 0;
+  int k = 0;
+  for (std::size_t i = 0; i != b.flat_count(); ++i)
+  {
+    auto e = std::bit_cast<byte_array<sizeof(E)>>(b.flat(i));
+    for (auto c : e.bytes)
+    {
+      w |= std::uint64_t{c} << 8*k;
+      if (++k == 8) {
+        h = hash_word(h, w);
+        w = 0;
+        k = 0;
+      }
+    }
+  }
+  if (k != 0)
+    h = hash_word(h, w);
+  return hash_fmix(h);
+}
+
+} // impl
+
+// hash functor extended to hash arrays by value, not by array id
+//
+struct hash
+{
+  template <hashable T>
+  constexpr std::size_t operator()(T const& v) const noexcept
+  {
+    using E = remove_all_extents_t<T>;
+
+    if constexpr (flat_size<T> == 0)
+      return impl::hash_bytes(nullptr, 0);
+    else if constexpr (std::is_floating_point_v<E>)
+    {
+      std::uint64_t h = flat_size<T> * impl::hash_k;
+      for (std::size_t i = 0; i != flat_size<T>; ++i)
+        h = impl::hash_word(h, impl::float_bits(flat_index(v,i)));
+      return impl::hash_fmix(h);
+    }
+    else if (std::is_constant_evaluated())
+    {
+      auto bytes = std::bit_cast<impl::byte_array<sizeof(T)>>(v);
+      return impl::hash_bytes(bytes.bytes, sizeof(T));
+    }
+    else
+      return impl::hash_bytes_n<sizeof(T)>(&v);
+  }
+
+  // operator()(b) hash of a bounded_array's elements, equal to the hash
+  //               of a C array of the same elements and extents
+  template <typename T>
+    requires hashable<T>
+  constexpr std::size_t operator()(bounded_array<T> b) const noexcept
+  {
+    using E = remove_all_extents_t<T>;
+
+    if constexpr (std::is_floating_point_v<E>)
+    {
+      std::uint64_t h = b.flat_count() * impl::hash_k;
+      for (std::size_t i = 0; i != b.flat_count(); ++i)
+        h = impl::hash_word(h, impl::float_bits(b.flat(i)));
+      return impl::hash_fmix(h);
+    }
+    else if (std::is_constant_evaluated())
+      return impl::hash_elements(b);
+    else
+#if defined(LML_KERNELS_LIB)
+      return impl::hash_bytes_lib(
+        reinterpret_cast<unsigned char const*>(b.data()), b.size_bytes());
+#else
+      return impl::hash_bytes(
+        reinterpret_cast<unsigned char const*>(b.data()), b.size_bytes());
+#endif
+  }
+
+  using is_transparent = void;
+};
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_HASH_HPP
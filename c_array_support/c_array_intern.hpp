@@ -0,0 +1,174 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_INTERN_HPP
+#define LML_C_ARRAY_INTERN_HPP
+/*
+  c_array_intern.hpp
+  ==================
+
+  intern_pool<A> stores unique values of array type A, returning a small
+  integer id for each distinct value, so that interned values compare
+  by id; one integer compare in place of an lml::equal_to array compare.
+
+  Depends on <compare>, <memory>, <optional>, <utility>, <vector>,
+  "c_array_hash.hpp", "c_array_compare.hpp" and "c_array_assign.hpp"
+
+  Usage
+  =====
+    lml::intern_pool<char[32]> symbols;
+    char name[32] = "alpha";
+
+    auto a = symbols.intern(name);   // copies the value in, if new
+    auto b = symbols.intern(name);   // finds the existing value
+    assert( a == b );                // integer compare
+
+    char const(&s)[32] = symbols[a]; // stable reference to the value
+
+    if (auto c = symbols.find(name)) ... // lookup without insert
+
+  Values are stored contiguously in chunked arenas of chunk_size values,
+  so references to interned values stay valid as the pool grows.
+  Lookup is by open addressing, linear probing, with the lml::hash of
+  each value kept to skip the array compare on hash mismatch.
+
+  Ids are dense, 0 to size()-1, in order of first interning, so ids of
+  the same pool compare by identity. Ids order by interning order, not
+  by value; use lml::less{}(pool[a],pool[b]) to order by value.
+*/
+
+#include <compare>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "c_array_hash.hpp"
+#include "c_array_compare.hpp"
+#include "c_array_assign.hpp"
+
+#include "namespace.hpp"
+
+// intern_pool<A,ChunkSize> pool of unique A values, referenced by id
+//
+template <c_array A,
+          std::size_t ChunkSize = (sizeof(A) && sizeof(A) < 0x10000)
+                                ? 0x10000 / sizeof(A) : 1>
+  requires (! std::is_reference_v<A> && ! std::is_const_v<A>
+         && hashable<A> && equality_comparable<A>
+         && std::is_copy_assignable_v<remove_all_extents_t<A>>
+         && ChunkSize != 0)
+class intern_pool
+{
+ public:
+  using value_type = A;
+
+  // id of an interned value, comparing by integer value
+  //
+  struct id
+  {
+    std::uint32_t value;
+    auto operator<=>(id const&) const = default;
+  };
+
+  static constexpr std::size_t chunk_size = ChunkSize;
+
+  intern_pool() = default;
+
+  // moves leave the moved-from pool empty, with a fresh table
+  //
+  intern_pool(intern_pool&& o) : intern_pool() { swap(o); }
+
+  intern_pool& operator=(intern_pool&& o)
+  {
+    intern_pool t(std::move(o));
+    swap(t);
+    return *this;
+  }
+
+  // intern(v) returns the id of value v, copying v into the pool if new
+  //
+  id intern(A const& v)
+  {
+    auto h = hash{}(v);
+    auto slot = probe(v, h);
+    if (table[slot] != 0)
+      return id{table[slot] - 1};
+
+    auto n = static_cast<std::uint32_t>(hashes.size());
+    if (n % ChunkSize == 0)
+      chunks.emplace_back(new A[ChunkSize]);
+    assign_to<A&>{chunks.back()[n % ChunkSize]} = v;
+    hashes.push_back(h);
+    table[slot] = n + 1;
+
+    if (2 * hashes.size() > table.size())
+      grow();
+    return id{n};
+  }
+
+  // find(v) returns the id of value v, if interned
+  //
+  std::optional<id> find(A const& v) const
+  {
+    if (auto slot = probe(v, hash{}(v)); table[slot] != 0)
+      return id{table[slot] - 1};
+    return std::nullopt;
+  }
+
+  bool contains(A const& v) const { return find(v).has_value(); }
+
+  A const& operator[](id i) const noexcept
+  {
+    return chunks[i.value / ChunkSize][i.value % ChunkSize];
+  }
+
+  std::size_t size() const noexcept { return hashes.size(); }
+
+ private:
+  std::vector<std::unique_ptr<A[]>> chunks;
+  std::vector<std::size_t> hashes;                 // by id
+  std::vector<std::uint32_t> table = std::vector<std::uint32_t>(16);
+                                                   // id + 1, 0 is empty
+
+  // probe(v,h) returns v's slot, or the empty slot where v would go
+  //
+  std::size_t probe(A const& v, std::size_t h) const
+  {
+    auto mask = table.size() - 1;
+    for (auto slot = h & mask; ; slot = (slot + 1) & mask)
+    {
+      auto e = table[slot];
+      if (e == 0 || (hashes[e - 1] == h
+                  && equal_to{}((*this)[id{e - 1}], v)))
+        return slot;
+    }
+  }
+
+  void swap(intern_pool& o) noexcept
+  {
+    chunks.swap(o.chunks);
+    hashes.swap(o.hashes);
+    table.swap(o.table);
+  }
+
+  void grow()
+  {
+    std::vector<std::uint32_t> bigger(table.size() * 2);
+    auto mask = bigger.size() - 1;
+    for (std::uint32_t n = 0; n != hashes.size(); ++n)
+    {
+      auto slot = hashes[n] & mask;
+      while (bigger[slot] != 0)
+        slot = (slot + 1) & mask;
+      bigger[slot] = n + 1;
+    }
+    table.swap(bigger);
+  }
+};
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_INTERN_HPP
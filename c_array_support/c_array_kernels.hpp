@@ -0,0 +1,781 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_KERNELS_HPP
+#define LML_C_ARRAY_KERNELS_HPP
+/*
+  c_array_kernels.hpp
+  ===================
+
+  Byte kernels behind the runtime paths of lml::assign, equal_to,
+  compare_three_way and less, with runtime CPU feature dispatch, so that
+  binaries built for baseline x86-64 use AVX2 or AVX-512 where present.
+
+  Depends on <atomic>, <bit>, <cstdint>, <cstdlib>, <cstring>,
+  <type_traits> and "c_array_bytes.hpp"
+  (plus <immintrin.h> on x86, <arm_neon.h> on AArch64, with GCC or Clang)
+
+  Usage
+  =====
+    Indirectly, via the runtime paths of the lml functors, if opted in
+    (see c_array_bytes.hpp); or directly
+
+    auto& k = lml::kernels();          // the active kernel table
+    std::size_t i = k.mismatch(p, q, n); // first differing byte, or n
+
+    lml::kernel_tier t = lml::active_kernel_tier();
+    lml::force_kernel_tier(lml::kernel_tier::scalar); // for testing
+
+  Tiers: scalar, sse2, avx2, avx512 (AVX-512BW) and neon; each kernel
+  table holds one function per kernel, compiled for its tier by target
+  attributes. The best tier the CPU supports is resolved once, on first
+  use, by __builtin_cpu_supports; it may be lowered, not raised, by the
+  environment variable LML_KERNEL_TIER (scalar, sse2, avx2, avx512 or
+  neon). force_kernel_tier(t) switches tables, if t is supported.
+
+  Kernels:
+    mismatch(a,b,n) the offset of the first differing byte, or n
+    copy(d,s,n)     memmove; the same at all tiers, as the C library's
+                    memmove is already dispatched (e.g. by glibc IFUNC)
+
+  The functor headers don't include this header; they call the entry
+  points of c_array_bytes.hpp, mismatch_bytes and move_bytes, which are
+  the mismatch and copy kernels of the active tier only when the
+  c_array_kernels library is linked or LML_KERNELS_DISPATCH is defined
+  (which makes c_array_bytes.hpp include this header).
+
+  Arrays are compared by kernel if they are bytewise_comparable: unpadded
+  with the same element type, with unique object representations (so
+  not float); the first differing byte then locates the first differing
+  element, which is compared as usual. Arrays smaller than
+  kernel_min_bytes keep the inline elementwise loop, which the compiler
+  can unroll. lml::hash does not dispatch; its value must not depend on
+  the tier.
+
+  The runtime paths of lml::assign, lml::equal_to and lml::hash go via
+  canonical functions keyed by byte count alone, copy_bytes_n<B>,
+  equal_bytes_n<B> (of c_array_bytes.hpp) and hash_bytes_n<B> (of
+  c_array_hash.hpp), so that all arrays of B bytes share one
+  instantiation, whatever their element type or shape; int[2][3], int[6]
+  and unsigned[3][2] share the code of 24 bytes.
+
+  Element kernels, fill_n(d,v,n) and find_n(p,v,n), serve lml::fill and
+  lml::find of c_array_algorithm.hpp for elements of 1, 2, 4 or 8 bytes,
+  passed as the unsigned integer of their size; memset and memchr for
+  bytes, otherwise loops for the compiler to vectorize.
+
+  The gather kernel, gather_n(d,s,idx,n,w,pf), serves lml::gather for
+  elements of 4 or 8 bytes with 32-bit indices; by AVX2 or AVX-512F
+  gather instructions at those tiers (compilers don't vectorize gathers
+  by themselves), else a scalar loop. With pf set, for sources too big
+  for cache, it prefetches the sources of indices gather_ahead elements
+  on.
+
+  The reverse kernel, reverse_n(p,n,w), serves lml::reverse and rotate
+  of c_array_algorithm.hpp along the innermost axis, for elements of 1,
+  2, 4 or 8 bytes; at the avx2 and avx512 tiers it swaps 32-byte blocks
+  from both ends, reversed by pshufb within lanes and vpermq across them
+  (compilers don't vectorize reversed loops), else a scalar loop.
+
+  The algorithms reach the element kernels, as the functors reach the
+  byte kernels, by entry points of c_array_bytes.hpp: fill_elements,
+  find_element, gather_elements and reverse_elements, only if opted in;
+  by default those are the portable loops the scalar kernels share.
+
+  Compiled library
+  ================
+  The kernels are inline, header-only, unless LML_KERNELS_LIB is defined,
+  as it is by linking the optional c_array_kernels library target (CMake
+  option C_ARRAY_SUPPORT_KERNELS_LIB, meson option kernels_lib). They're
+  then only declared here, and compiled once, in src/c_array_kernels.cpp,
+  with the element kernels multiversioned by target_clones (default, AVX2
+  and AVX-512F) where ifunc is supported. Constant evaluation doesn't use
+  kernels, so constexpr use is unaffected.
+*/
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LML_KERNELS_X86 1
+#elif defined(__GNUC__) && defined(__aarch64__)
+#include <arm_neon.h>
+#define LML_KERNELS_NEON 1
+#endif
+
+#include "c_array_support.hpp"
+#include "c_array_bytes.hpp"
+
+#include "namespace.hpp"
+
+enum class kernel_tier { scalar, sse2, avx2, avx512, neon };
+
+inline constexpr char const* kernel_tier_names[]
+                           = {"scalar", "sse2", "avx2", "avx512", "neon"};
+
+// kernel_table one function pointer per kernel, all for the same tier
+//
+struct kernel_table
+{
+  kernel_tier tier;
+  std::size_t (*mismatch)(void const*, void const*, std::size_t) noexcept;
+  void (*copy)(void*, void const*, std::size_t) noexcept;
+};
+
+// LML_KERNELS_LIB is defined when the c_array_kernels library is linked;
+//  the kernels are then compiled out of line, in src/c_array_kernels.cpp,
+//  and only declared here. Otherwise they're inline, header-only.
+//
+#if ! defined(LML_KERNELS_LIB)
+#define LML_KERNEL inline
+#define LML_KERNEL_DEFINE
+#elif defined(LML_KERNELS_SOURCE)
+#define LML_KERNEL
+#define LML_KERNEL_DEFINE
+#else
+#define LML_KERNEL
+#endif
+
+// LML_KERNEL_CLONES multiversions the element kernels in the library;
+//  the memset and memchr kernels are left to the C library
+#if ! defined(LML_KERNEL_CLONES)
+#define LML_KERNEL_CLONES
+#endif
+
+namespace impl {
+
+// Byte kernels, one per tier
+
+LML_KERNEL void copy_bytes(void* d, void const* s, std::size_t n) noexcept;
+
+LML_KERNEL std::size_t mismatch_scalar(void const* l, void const* r,
+                                       std::size_t n) noexcept;
+#if defined(LML_KERNELS_X86)
+__attribute__((target("sse2")))
+LML_KERNEL std::size_t mismatch_sse2(void const* l, void const* r,
+                                     std::size_t n) noexcept;
+__attribute__((target("avx2")))
+LML_KERNEL std::size_t mismatch_avx2(void const* l, void const* r,
+                                     std::size_t n) noexcept;
+__attribute__((target("avx512f,avx512bw")))
+LML_KERNEL std::size_t mismatch_avx512(void const* l, void const* r,
+                                       std::size_t n) noexcept;
+#elif defined(LML_KERNELS_NEON)
+LML_KERNEL std::size_t mismatch_neon(void const* l, void const* r,
+                                     std::size_t n) noexcept;
+#endif
+
+// Element kernels, for elements of 1, 2, 4 or 8 bytes, the same at all
+//  tiers; left to the compiler to vectorize, or to multiversion in the
+//  library build
+
+// fill_n(d,v,n) stores v in each of n elements at d
+//
+LML_KERNEL
+void fill_n(void* d, std::uint8_t v, std::size_t n) noexcept;
+LML_KERNEL_CLONES LML_KERNEL
+void fill_n(void* d, std::uint16_t v, std::size_t n) noexcept;
+LML_KERNEL_CLONES LML_KERNEL
+void fill_n(void* d, std::uint32_t v, std::size_t n) noexcept;
+LML_KERNEL_CLONES LML_KERNEL
+void fill_n(void* d, std::uint64_t v, std::size_t n) noexcept;
+
+// find_n(p,v,n) index of the first of n elements at p equal to v, or n
+//
+LML_KERNEL
+std::size_t find_n(void const* p, std::uint8_t v,
+                   std::size_t n) noexcept;
+LML_KERNEL_CLONES LML_KERNEL
+std::size_t find_n(void const* p, std::uint16_t v,
+                   std::size_t n) noexcept;
+LML_KERNEL_CLONES LML_KERNEL
+std::size_t find_n(void const* p, std::uint32_t v,
+                   std::size_t n) noexcept;
+LML_KERNEL_CLONES LML_KERNEL
+std::size_t find_n(void const* p, std::uint64_t v,
+                   std::size_t n) noexcept;
+
+// gather kernels, d[i] = s[idx[i]] for n elements of w = 4 or 8 bytes,
+//  with 32-bit indices idx; one per tier, selected by gather_n
+//
+LML_KERNEL void gather_scalar(void* d, void const* s, void const* idx,
+                              std::size_t n, std::size_t w,
+                              bool pf) noexcept;
+#if defined(LML_KERNELS_X86)
+__attribute__((target("avx2")))
+LML_KERNEL void gather_avx2(void* d, void const* s, void const* idx,
+                            std::size_t n, std::size_t w, bool pf) noexcept;
+__attribute__((target("avx512f")))
+LML_KERNEL void gather_avx512(void* d, void const* s, void const* idx,
+                              std::size_t n, std::size_t w,
+                              bool pf) noexcept;
+#endif
+
+// reverse kernels, reverse the order of n elements of w = 1, 2, 4 or 8
+//  bytes at p, in place; one per tier, selected by reverse_n
+//
+LML_KERNEL void reverse_scalar(void* p, std::size_t n,
+                               std::size_t w) noexcept;
+#if defined(LML_KERNELS_X86)
+__attribute__((target("avx2")))
+LML_KERNEL void reverse_avx2(void* p, std::size_t n,
+                             std::size_t w) noexcept;
+#endif
+
+#if defined(LML_KERNEL_DEFINE)
+
+LML_KERNEL void copy_bytes(void* d, void const* s, std::size_t n) noexcept
+{
+  std::memmove(d, s, n);
+}
+
+LML_KERNEL std::size_t mismatch_scalar(void const* l, void const* r,
+                                       std::size_t n) noexcept
+{
+  return mismatch_words(l, r, n);
+}
+
+#if defined(LML_KERNELS_X86)
+
+__attribute__((target("sse2")))
+LML_KERNEL std::size_t mismatch_sse2(void const* l, void const* r,
+                                     std::size_t n) noexcept
+{
+  auto a = static_cast<unsigned char const*>(l);
+  auto b = static_cast<unsigned char const*>(r);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    auto x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i));
+    auto y = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i));
+    unsigned eq = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+    if (eq != 0xFFFF)
+      return i + std::countr_one(eq);
+  }
+  return mismatch_tail(a, b, i, n);
+}
+
+__attribute__((target("avx2")))
+LML_KERNEL std::size_t mismatch_avx2(void const* l, void const* r,
+                                     std::size_t n) noexcept
+{
+  auto a = static_cast<unsigned char const*>(l);
+  auto b = static_cast<unsigned char const*>(r);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    auto x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+    auto y = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i));
+    auto eq = static_cast<unsigned>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    if (eq != 0xFFFFFFFFu)
+      return i + std::countr_one(eq);
+  }
+  return mismatch_tail(a, b, i, n);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+LML_KERNEL std::size_t mismatch_avx512(void const* l, void const* r,
+                                       std::size_t n) noexcept
+{
+  auto a = static_cast<unsigned char const*>(l);
+  auto b = static_cast<unsigned char const*>(r);
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64)
+  {
+    auto x = _mm512_loadu_si512(a + i);
+    auto y = _mm512_loadu_si512(b + i);
+    std::uint64_t ne = _mm512_cmpneq_epu8_mask(x, y);
+    if (ne != 0)
+      return i + std::countr_zero(ne);
+  }
+  if (i != n)
+  {
+    auto rest = (std::uint64_t{1} << (n - i)) - 1;
+    auto x = _mm512_maskz_loadu_epi8(rest, a + i);
+    auto y = _mm512_maskz_loadu_epi8(rest, b + i);
+    std::uint64_t ne = _mm512_cmpneq_epu8_mask(x, y);
+    return ne ? i + std::countr_zero(ne) : n;
+  }
+  return n;
+}
+
+#endif // LML_KERNELS_X86
+
+#if defined(LML_KERNELS_NEON)
+
+LML_KERNEL std::size_t mismatch_neon(void const* l, void const* r,
+                                     std::size_t n) noexcept
+{
+  auto a = static_cast<unsigned char const*>(l);
+  auto b = static_cast<unsigned char const*>(r);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    if (vminvq_u8(vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i))) == 0)
+      return mismatch_tail(a, b, i, i + 16);
+  return mismatch_tail(a, b, i, n);
+}
+
+#endif // LML_KERNELS_NEON
+
+LML_KERNEL
+void fill_n(void* d, std::uint8_t v, std::size_t n) noexcept
+{
+  std::memset(d, v, n);
+}
+
+LML_KERNEL_CLONES LML_KERNEL
+void fill_n(void* d, std::uint16_t v, std::size_t n) noexcept
+{
+  fill_loop(d, v, n);
+}
+
+LML_KERNEL_CLONES LML_KERNEL
+void fill_n(void* d, std::uint32_t v, std::size_t n) noexcept
+{
+  fill_loop(d, v, n);
+}
+
+LML_KERNEL_CLONES LML_KERNEL
+void fill_n(void* d, std::uint64_t v, std::size_t n) noexcept
+{
+  fill_loop(d, v, n);
+}
+
+LML_KERNEL
+std::size_t find_n(void const* p, std::uint8_t v,
+                   std::size_t n) noexcept
+{
+  auto f = n ? std::memchr(p, v, n) : nullptr;
+  return f ? static_cast<std::size_t>(static_cast<char const*>(f)
+                                    - static_cast<char const*>(p)) : n;
+}
+
+LML_KERNEL_CLONES LML_KERNEL
+std::size_t find_n(void const* p, std::uint16_t v,
+                   std::size_t n) noexcept
+{
+  return find_loop(p, v, n);
+}
+
+LML_KERNEL_CLONES LML_KERNEL
+std::size_t find_n(void const* p, std::uint32_t v,
+                   std::size_t n) noexcept
+{
+  return find_loop(p, v, n);
+}
+
+LML_KERNEL_CLONES LML_KERNEL
+std::size_t find_n(void const* p, std::uint64_t v,
+                   std::size_t n) noexcept
+{
+  return find_loop(p, v, n);
+}
+
+LML_KERNEL void gather_scalar(void* d, void const* s, void const* idx,
+                              std::size_t n, std::size_t w,
+                              bool pf) noexcept
+{
+  if (w == 4)
+    gather_loop<std::uint32_t>(d, s, idx, 0, n, pf);
+  else
+    gather_loop<std::uint64_t>(d, s, idx, 0, n, pf);
+}
+
+#if defined(LML_KERNELS_X86)
+
+// gather_prefetch(s,ip,i,n,L,w) prefetches the sources of the L indices
+//  from i + gather_ahead, if in range
+//
+inline void gather_prefetch(unsigned char const* s, unsigned char const* ip,
+                            std::size_t i, std::size_t n,
+                            std::size_t lanes, std::size_t w) noexcept
+{
+  if (i + gather_ahead + lanes <= n)
+    for (std::size_t j = 0; j != lanes; ++j)
+      prefetch(s + load<std::uint32_t>(ip, i + gather_ahead + j) * w);
+}
+
+__attribute__((target("avx2")))
+LML_KERNEL void gather_avx2(void* d, void const* s, void const* idx,
+                            std::size_t n, std::size_t w, bool pf) noexcept
+{
+  auto dp = static_cast<unsigned char*>(d);
+  auto sp = static_cast<unsigned char const*>(s);
+  auto ip = static_cast<unsigned char const*>(idx);
+  std::size_t i = 0;
+  if (w == 4) {
+    auto base = reinterpret_cast<int const*>(sp);
+    for (; i + 8 <= n; i += 8) {
+      if (pf)
+        gather_prefetch(sp, ip, i, n, 8, 4);
+      auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(ip + 4*i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dp + 4*i),
+                          _mm256_i32gather_epi32(base, v, 4));
+    }
+    gather_loop<std::uint32_t>(d, s, idx, i, n, pf);
+  } else {
+    auto base = reinterpret_cast<long long const*>(sp);
+    for (; i + 4 <= n; i += 4) {
+      if (pf)
+        gather_prefetch(sp, ip, i, n, 4, 8);
+      auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ip + 4*i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dp + 8*i),
+                          _mm256_i32gather_epi64(base, v, 8));
+    }
+    gather_loop<std::uint64_t>(d, s, idx, i, n, pf);
+  }
+}
+
+__attribute__((target("avx512f")))
+LML_KERNEL void gather_avx512(void* d, void const* s, void const* idx,
+                              std::size_t n, std::size_t w,
+                              bool pf) noexcept
+{
+  auto dp = static_cast<unsigned char*>(d);
+  auto sp = static_cast<unsigned char const*>(s);
+  auto ip = static_cast<unsigned char const*>(idx);
+  std::size_t i = 0;
+  if (w == 4) {
+    for (; i + 16 <= n; i += 16) {
+      if (pf)
+        gather_prefetch(sp, ip, i, n, 16, 4);
+      auto v = _mm512_loadu_si512(ip + 4*i);
+      _mm512_storeu_si512(dp + 4*i, _mm512_mask_i32gather_epi32(
+                                      _mm512_setzero_si512(), 0xffff,
+                                      v, sp, 4));
+    }
+    gather_loop<std::uint32_t>(d, s, idx, i, n, pf);
+  } else {
+    for (; i + 8 <= n; i += 8) {
+      if (pf)
+        gather_prefetch(sp, ip, i, n, 8, 8);
+      auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(ip + 4*i));
+      _mm512_storeu_si512(dp + 8*i, _mm512_mask_i32gather_epi64(
+                                      _mm512_setzero_si512(), 0xff,
+                                      v, sp, 8));
+    }
+    gather_loop<std::uint64_t>(d, s, idx, i, n, pf);
+  }
+}
+
+#endif // LML_KERNELS_X86
+
+LML_KERNEL void reverse_scalar(void* p, std::size_t n,
+                               std::size_t w) noexcept
+{
+  reverse_range(static_cast<unsigned char*>(p), 0, n, w);
+}
+
+#if defined(LML_KERNELS_X86)
+
+// reverse_shuffle<W> pshufb control that reverses the elements of W bytes
+//  within each 16-byte lane, twice over for a 32-byte vector
+//
+template <std::size_t W>
+struct reverse_shuffle
+{
+  alignas(32) unsigned char m[32];
+  constexpr reverse_shuffle() : m{}
+  {
+    for (std::size_t j = 0; j != 32; ++j)
+      m[j] = static_cast<unsigned char>((16 / W - 1 - j % 16 / W) * W
+                                        + j % W);
+  }
+};
+template <std::size_t W>
+inline constexpr reverse_shuffle<W> reverse_shuffle_v{};
+
+// reverse_vector(x,m) the elements of x reversed, by pshufb control m
+//  within lanes, then vpermq to swap the lanes
+//
+__attribute__((target("avx2")))
+inline __m256i reverse_vector(__m256i x, __m256i m) noexcept
+{
+  return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, m), 0x4e);
+}
+
+// reverse_blocks_avx2<W>(b,lo,hi) swaps the byte blocks at either end of
+//  [lo,hi), each with its elements reversed, 32 bytes at a time, then 16;
+//  lo and hi are left bounding the unswapped middle, under 32 bytes
+//
+template <std::size_t W>
+__attribute__((target("avx2")))
+inline void reverse_blocks_avx2(unsigned char* b, std::size_t& lo,
+                                std::size_t& hi) noexcept
+{
+  auto m = _mm256_load_si256(
+             reinterpret_cast<__m256i const*>(reverse_shuffle_v<W>.m));
+  for (; hi - lo >= 64; lo += 32, hi -= 32)
+  {
+    auto x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + lo));
+    auto y = _mm256_loadu_si256(
+               reinterpret_cast<__m256i const*>(b + hi - 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + lo),
+                        reverse_vector(y, m));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + hi - 32),
+                        reverse_vector(x, m));
+  }
+  if (hi - lo >= 32)
+  {
+    auto m16 = _mm256_castsi256_si128(m);
+    auto x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + lo));
+    auto y = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + hi - 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(b + lo),
+                     _mm_shuffle_epi8(y, m16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(b + hi - 16),
+                     _mm_shuffle_epi8(x, m16));
+    lo += 16;
+    hi -= 16;
+  }
+}
+
+__attribute__((target("avx2")))
+LML_KERNEL void reverse_avx2(void* p, std::size_t n,
+                             std::size_t w) noexcept
+{
+  auto b = static_cast<unsigned char*>(p);
+  std::size_t lo = 0, hi = n * w;
+  switch (w) {
+    case 1:  reverse_blocks_avx2<1>(b, lo, hi); break;
+    case 2:  reverse_blocks_avx2<2>(b, lo, hi); break;
+    case 4:  reverse_blocks_avx2<4>(b, lo, hi); break;
+    default: reverse_blocks_avx2<8>(b, lo, hi); break;
+  }
+  reverse_range(b, lo / w, hi / w, w);
+}
+
+#endif // LML_KERNELS_X86
+
+#endif // LML_KERNEL_DEFINE
+
+inline constexpr kernel_table tables[] = {
+  {kernel_tier::scalar, mismatch_scalar, copy_bytes},
+#if defined(LML_KERNELS_X86)
+  {kernel_tier::sse2,   mismatch_sse2,   copy_bytes},
+  {kernel_tier::avx2,   mismatch_avx2,   copy_bytes},
+  {kernel_tier::avx512, mismatch_avx512, copy_bytes},
+#elif defined(LML_KERNELS_NEON)
+  {kernel_tier::neon,   mismatch_neon,   copy_bytes},
+#endif
+};
+
+inline kernel_table const* find_table(kernel_tier t) noexcept
+{
+  for (auto& k : tables)
+    if (k.tier == t)
+      return &k;
+  return nullptr;
+}
+
+inline bool cpu_supports(kernel_tier t) noexcept
+{
+#if defined(LML_KERNELS_X86)
+  __builtin_cpu_init();
+  switch (t) {
+    case kernel_tier::scalar: return true;
+    case kernel_tier::sse2:   return __builtin_cpu_supports("sse2");
+    case kernel_tier::avx2:   return __builtin_cpu_supports("avx2");
+    case kernel_tier::avx512: return __builtin_cpu_supports("avx512f")
+                                  && __builtin_cpu_supports("avx512bw");
+    default: return false;
+  }
+#elif defined(LML_KERNELS_NEON)
+  return t == kernel_tier::scalar || t == kernel_tier::neon;
+#else
+  return t == kernel_tier::scalar;
+#endif
+}
+
+// best_table() the highest supported tier, capped by LML_KERNEL_TIER
+//
+inline kernel_table const* best_table() noexcept
+{
+  auto cap = static_cast<int>(kernel_tier::neon);
+  if (char const* env = std::getenv("LML_KERNEL_TIER"))
+    for (int t = 0; auto name : kernel_tier_names)
+    {
+      if (std::strcmp(env, name) == 0)
+        cap = t;
+      ++t;
+    }
+  kernel_table const* best = &tables[0];
+  for (auto& k : tables)
+    if (static_cast<int>(k.tier) <= cap && cpu_supports(k.tier))
+      best = &k;
+  return best;
+}
+
+inline std::atomic<kernel_table const*> active_table{nullptr};
+
+// resolve_table() resolves the active table on first use; kept apart
+//  from kernels() so that its inline fast path is a load and a test
+//
+#if defined(__GNUC__)
+__attribute__((noinline, cold))
+#elif defined(_MSC_VER)
+__declspec(noinline)
+#endif
+inline kernel_table const& resolve_table() noexcept
+{
+  static kernel_table const* const best = best_table();
+  active_table.store(best, std::memory_order_relaxed);
+  return *best;
+}
+
+} // impl
+
+// kernels() the active kernel table, resolved on first use
+//
+inline kernel_table const& kernels() noexcept
+{
+  auto k = impl::active_table.load(std::memory_order_relaxed);
+  return k ? *k : impl::resolve_table();
+}
+
+inline kernel_tier active_kernel_tier() noexcept { return kernels().tier; }
+
+// kernel_tier_supported(t) true if tier t is compiled in and the CPU
+//  supports it
+//
+inline bool kernel_tier_supported(kernel_tier t) noexcept
+{
+  return impl::find_table(t) && impl::cpu_supports(t);
+}
+
+// force_kernel_tier(t) makes t the active tier, if supported; for tests
+//  and benchmarks, not to be called while kernels run in other threads
+//
+inline bool force_kernel_tier(kernel_tier t) noexcept
+{
+  if (! kernel_tier_supported(t))
+    return false;
+  impl::active_table.store(impl::find_table(t), std::memory_order_relaxed);
+  return true;
+}
+
+namespace impl {
+
+// mismatch_bytes and move_bytes of c_array_bytes.hpp, by the active tier,
+//  for the LML_KERNELS_DISPATCH build, or compiled in the library
+//
+#if defined(LML_KERNELS_SOURCE) \
+ || (defined(LML_KERNELS_DISPATCH) && ! defined(LML_KERNELS_LIB))
+LML_KERNEL std::size_t mismatch_bytes(void const* l, void const* r,
+                                      std::size_t n) noexcept
+{
+  return kernels().mismatch(l, r, n);
+}
+
+LML_KERNEL void move_bytes(void* d, void const* s, std::size_t n) noexcept
+{
+  kernels().copy(d, s, n);
+}
+#endif
+
+// gather_n(d,s,idx,n,w,pf) the gather kernel of the active tier
+//
+inline void gather_n(void* d, void const* s, void const* idx,
+                     std::size_t n, std::size_t w, bool pf) noexcept
+{
+#if defined(LML_KERNELS_X86)
+  switch (active_kernel_tier()) {
+    case kernel_tier::avx2:   return gather_avx2(d, s, idx, n, w, pf);
+    case kernel_tier::avx512: return gather_avx512(d, s, idx, n, w, pf);
+    default: break;
+  }
+#endif
+  gather_scalar(d, s, idx, n, w, pf);
+}
+
+// reverse_n(p,n,w) the reverse kernel of the active tier
+//
+inline void reverse_n(void* p, std::size_t n, std::size_t w) noexcept
+{
+#if defined(LML_KERNELS_X86)
+  switch (active_kernel_tier()) {
+    case kernel_tier::avx2:
+    case kernel_tier::avx512: return reverse_avx2(p, n, w);
+    default: break;
+  }
+#endif
+  reverse_scalar(p, n, w);
+}
+
+// fill_elements, find_element, gather_elements and reverse_elements of
+//  c_array_bytes.hpp, by the element kernels, as for mismatch_bytes
+//
+#if defined(LML_KERNELS_SOURCE) \
+ || (defined(LML_KERNELS_DISPATCH) && ! defined(LML_KERNELS_LIB))
+LML_KERNEL void fill_elements(void* d, std::uint8_t v,
+                              std::size_t n) noexcept
+{
+  fill_n(d, v, n);
+}
+LML_KERNEL void fill_elements(void* d, std::uint16_t v,
+                              std::size_t n) noexcept
+{
+  fill_n(d, v, n);
+}
+LML_KERNEL void fill_elements(void* d, std::uint32_t v,
+                              std::size_t n) noexcept
+{
+  fill_n(d, v, n);
+}
+LML_KERNEL void fill_elements(void* d, std::uint64_t v,
+                              std::size_t n) noexcept
+{
+  fill_n(d, v, n);
+}
+
+LML_KERNEL std::size_t find_element(void const* p, std::uint8_t v,
+                                    std::size_t n) noexcept
+{
+  return find_n(p, v, n);
+}
+LML_KERNEL std::size_t find_element(void const* p, std::uint16_t v,
+                                    std::size_t n) noexcept
+{
+  return find_n(p, v, n);
+}
+LML_KERNEL std::size_t find_element(void const* p, std::uint32_t v,
+                                    std::size_t n) noexcept
+{
+  return find_n(p, v, n);
+}
+LML_KERNEL std::size_t find_element(void const* p, std::uint64_t v,
+                                    std::size_t n) noexcept
+{
+  return find_n(p, v, n);
+}
+
+LML_KERNEL void gather_elements(void* d, void const* s, void const* idx,
+                                std::size_t n, std::size_t w,
+                                bool pf) noexcept
+{
+  gather_n(d, s, idx, n, w, pf);
+}
+
+LML_KERNEL void reverse_elements(void* p, std::size_t n,
+                                 std::size_t w) noexcept
+{
+  reverse_n(p, n, w);
+}
+#endif
+
+} // impl
+
+#include "namespace.hpp"
+
+#undef LML_KERNEL
+#undef LML_KERNEL_DEFINE
+#undef LML_KERNEL_CLONES
+
+#endif // LML_C_ARRAY_KERNELS_HPP
@@ -0,0 +1,328 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_MEMBERS_HPP
+#define LML_C_ARRAY_MEMBERS_HPP
+/*
+  c_array_members.hpp
+  ===================
+
+  Memberwise assign and three-way compare of aggregates that hold C
+  arrays among their members, with adjacent bytewise members coalesced
+  into single memmove or memcmp calls.
+
+  Depends on <compare>, <cstring>, <memory>, "c_array_assign.hpp"
+  and "c_array_compare.hpp"
+
+  Traits and concepts:
+
+    lml::member_count_v<T>      number of members of aggregate T
+    lml::member_aggregate<T>    aggregate class T with <= 16 members,
+                                that can be bound by structured binding
+
+  Functions:
+
+    lml::assign_members(d,s)    assigns each member of s to that of d
+    lml::compare_members(l,r)   lexicographic <=> over the members
+
+  Usage
+  =====
+    struct rec { int id; char tag[12]; std::string name; double w[4]; };
+    rec a{}, b{};
+    lml::assign_members(a, b);           // memmove id,tag; name = ; w
+    assert( lml::compare_members(a, b) == 0 );
+
+  Member count is detected by brace-initialization, T{{m},{m}...},
+  which counts array members once, then members are bound by structured
+  binding. The aggregate must have no base classes (so that structured
+  binding works) and no more than 16 members.
+
+  assign_members(d,s) assigns arrays by lml::assign, others by operator=.
+  Runs of adjacent, trivially copyable members (with no padding between
+  them) are moved as one block of bytes; a trivially copyable aggregate
+  is moved whole.
+
+  compare_members(l,r) returns the common comparison category of the
+  member comparisons, by lml::compare_three_way so that array members
+  compare as arrays. Runs of adjacent members with unique object
+  representations and scalar elements (ints and pointers, not floats)
+  are first checked for equality by one memcmp; only a differing run
+  is then compared member by member, for the ordering.
+
+  Adjacency is checked at runtime, a comparison of member addresses per
+  member (member offsets can't be had at compile time without names),
+  which compilers fold where the call is inlined. Constant evaluation
+  goes member by member.
+*/
+
+#include <compare>
+#include <cstring>
+#include <memory>
+
+#include "c_array_assign.hpp"
+#include "c_array_compare.hpp"
+
+#include "namespace.hpp"
+
+namespace impl {
+
+// any_member converts to any member type, for member counting
+//
+struct any_member
+{
+  template <typename U> operator U() const noexcept;
+};
+
+template <typename T, typename... A>
+consteval std::size_t count_members()
+{
+  if constexpr (sizeof...(A) > 16)
+    return sizeof...(A);
+  else if constexpr (requires { T{ {A{}}..., {any_member{}} }; })
+    return count_members<T, A..., any_member>();
+  else
+    return sizeof...(A);
+}
+
+} // impl
+
+// member_count_v<T> the number of members of aggregate T
+//                   (array members count once)
+//
+template <typename T>
+  requires std::is_aggregate_v<T>
+inline constexpr std::size_t member_count_v = impl::count_members<T>();
+
+// member_aggregate<T> concept: aggregate non-array class T of at most
+//                     16 members
+//
+template <typename T>
+concept member_aggregate = std::is_class_v<std::remove_cvref_t<T>>
+                        && std::is_aggregate_v<std::remove_cvref_t<T>>
+                        && member_count_v<std::remove_cvref_t<T>> <= 16;
+
+namespace impl {
+
+// with_members(t,f) f(m...) called with the members of t as lvalues
+//
+template <typename T, typename F>
+constexpr decltype(auto) with_members(T& t, F&& f)
+{
+  constexpr auto n = member_count_v<std::remove_cv_t<T>>;
+  if constexpr (n == 0) { return f(); }
+  else if constexpr (n == 1) { auto& [a] = t; return f(a); }
+  else if constexpr (n == 2) { auto& [a,b] = t; return f(a,b); }
+  else if constexpr (n == 3) { auto& [a,b,c] = t; return f(a,b,c); }
+  else if constexpr (n == 4) { auto& [a,b,c,d] = t; return f(a,b,c,d); }
+  else if constexpr (n == 5) {
+    auto& [a,b,c,d,e] = t; return f(a,b,c,d,e); }
+  else if constexpr (n == 6) {
+    auto& [a,b,c,d,e,g] = t; return f(a,b,c,d,e,g); }
+  else if constexpr (n == 7) {
+    auto& [a,b,c,d,e,g,h] = t; return f(a,b,c,d,e,g,h); }
+  else if constexpr (n == 8) {
+    auto& [a,b,c,d,e,g,h,i] = t; return f(a,b,c,d,e,g,h,i); }
+  else if constexpr (n == 9) {
+    auto& [a,b,c,d,e,g,h,i,j] = t; return f(a,b,c,d,e,g,h,i,j); }
+  else if constexpr (n == 10) {
+    auto& [a,b,c,d,e,g,h,i,j,k] = t; return f(a,b,c,d,e,g,h,i,j,k); }
+  else if constexpr (n == 11) {
+    auto& [a,b,c,d,e,g,h,i,j,k,l] = t;
+    return f(a,b,c,d,e,g,h,i,j,k,l); }
+  else if constexpr (n == 12) {
+    auto& [a,b,c,d,e,g,h,i,j,k,l,m] = t;
+    return f(a,b,c,d,e,g,h,i,j,k,l,m); }
+  else if constexpr (n == 13) {
+    auto& [a,b,c,d,e,g,h,i,j,k,l,m,o] = t;
+    return f(a,b,c,d,e,g,h,i,j,k,l,m,o); }
+  else if constexpr (n == 14) {
+    auto& [a,b,c,d,e,g,h,i,j,k,l,m,o,p] = t;
+    return f(a,b,c,d,e,g,h,i,j,k,l,m,o,p); }
+  else if constexpr (n == 15) {
+    auto& [a,b,c,d,e,g,h,i,j,k,l,m,o,p,q] = t;
+    return f(a,b,c,d,e,g,h,i,j,k,l,m,o,p,q); }
+  else {
+    auto& [a,b,c,d,e,g,h,i,j,k,l,m,o,p,q,r] = t;
+    return f(a,b,c,d,e,g,h,i,j,k,l,m,o,p,q,r); }
+}
+
+// bytewise_member<M> member type M can be assigned as bytes
+//
+template <typename M, typename E = remove_all_extents_t<M>>
+inline constexpr bool bytewise_member = ! std::is_const_v<E>
+                                     && ! std::is_volatile_v<E>
+                                     && std::is_trivially_copyable_v<E>
+                                  && std::is_trivially_copy_assignable_v<E>;
+
+// bytewise_comparable_member<M> member type M compares as its bytes
+//
+template <typename M, typename E = remove_all_extents_t<M>>
+inline constexpr bool bytewise_comparable_member = ! std::is_volatile_v<E>
+                                     && std::is_scalar_v<E>
+                     && std::has_unique_object_representations_v<
+                                                     std::remove_cv_t<E>>;
+
+// byte_run a run of adjacent members, as the bytes of l and of r,
+//  from member index 'first', ended by flush()
+//
+template <typename LB, typename RB>
+struct byte_run
+{
+  LB* l = nullptr;
+  RB* r = nullptr;
+  std::size_t size = 0;
+  std::size_t first = 0;
+
+  // extend(l,r,i) extends the run by member i, if adjacent, returning
+  //               false if the run must first be flushed
+  template <typename M, typename N>
+  bool extend(M& ml, N& mr, std::size_t i) noexcept
+  {
+    auto pl = reinterpret_cast<LB*>(std::addressof(ml));
+    auto pr = reinterpret_cast<RB*>(std::addressof(mr));
+    if (size != 0 && (pl != l + size || pr != r + size))
+      return false;
+    if (size == 0) {
+      l = pl;
+      r = pr;
+      first = i;
+    }
+    size += sizeof(M);
+    return true;
+  }
+};
+
+} // impl
+
+// assign_members(d,s) assigns each member of s to that of d, returns d;
+//                     arrays by lml::assign, adjacent bytes coalesced
+//
+template <member_aggregate T>
+  requires (! std::is_const_v<T>)
+constexpr T& assign_members(T& d, T const& s)
+{
+  if constexpr (std::is_trivially_copyable_v<T>
+             && std::is_trivially_copy_assignable_v<T>)
+    if (! std::is_constant_evaluated()) {
+      std::memmove(std::addressof(d), std::addressof(s), sizeof(T));
+      return d;
+    }
+  if constexpr (member_count_v<T> != 0) {
+    impl::with_members(d, [&](auto&... dm) {
+      impl::with_members(s, [&](auto const&... sm) {
+        if (std::is_constant_evaluated()) {
+          ((void)(assign(dm) = sm), ...);
+          return;
+        }
+        impl::byte_run<unsigned char, unsigned char const> run;
+        auto flush = [&] {
+          if (run.size != 0)
+            std::memmove(run.l, run.r, run.size);
+          run.size = 0;
+        };
+        std::size_t i = 0;
+        ([&](auto& ml, auto const& mr) {
+          using M = std::remove_reference_t<decltype(ml)>;
+          if constexpr (impl::bytewise_member<M>) {
+            if (! run.extend(ml, mr, i)) {
+              flush();
+              run.extend(ml, mr, i);
+            }
+          } else {
+            flush();
+            assign(ml) = mr;
+          }
+          ++i;
+        }(dm, sm), ...);
+        flush();
+      });
+    });
+  }
+  return d;
+}
+
+namespace impl {
+
+// member_compare callable, declared only, to find the comparison category
+//
+struct member_compare
+{
+  template <typename... M>
+  auto operator()(M const&...) const
+    -> std::common_comparison_category_t<
+         decltype(lml::compare_three_way{}(std::declval<M const&>(),
+                                           std::declval<M const&>()))...>;
+};
+
+// member_compare_t<T> the common comparison category of T's members
+//
+template <typename T>
+using member_compare_t = decltype(with_members(std::declval<T const&>(),
+                                               member_compare{}));
+
+} // impl
+
+// compare_members(l,r) lexicographic three-way comparison of the members
+//                      of l and r; equal runs of bytes skipped by memcmp
+//
+template <member_aggregate T>
+constexpr auto compare_members(T const& l, T const& r)
+  -> impl::member_compare_t<T>
+{
+  using C = impl::member_compare_t<T>;
+  if constexpr (member_count_v<T> == 0)
+    return C::equivalent;
+  else {
+    return impl::with_members(l, [&](auto const&... lm) {
+      return impl::with_members(r, [&](auto const&... rm) {
+        C c = C::equivalent;
+        // compare(lo,hi) compares members [lo,hi) one by one, into c
+        auto compare = [&](std::size_t lo, std::size_t hi) {
+          std::size_t i = 0;
+          ([&](auto const& ml, auto const& mr) {
+            if (c == 0 && i >= lo && i < hi)
+              c = lml::compare_three_way{}(ml, mr);
+            ++i;
+          }(lm, rm), ...);
+        };
+        if (std::is_constant_evaluated()) {
+          compare(0, sizeof...(lm));
+          return c;
+        }
+        impl::byte_run<unsigned char const, unsigned char const> run;
+        auto flush = [&](std::size_t end) {
+          if (run.size != 0 && std::memcmp(run.l, run.r, run.size) != 0)
+            compare(run.first, end);
+          run.size = 0;
+        };
+        std::size_t i = 0;
+        ([&](auto const& ml, auto const& mr) {
+          using M = std::remove_cvref_t<decltype(ml)>;
+          if (c == 0) {
+            if constexpr (impl::bytewise_comparable_member<M>) {
+              if (! run.extend(ml, mr, i)) {
+                flush(i);
+                if (c == 0)
+                  run.extend(ml, mr, i);
+              }
+            } else {
+              flush(i);
+              if (c == 0)
+                c = lml::compare_three_way{}(ml, mr);
+            }
+          }
+          ++i;
+        }(lm, rm), ...);
+        if (c == 0)
+          flush(i);
+        return c;
+      });
+    });
+  }
+}
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_MEMBERS_HPP
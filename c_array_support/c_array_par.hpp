@@ -0,0 +1,381 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_PAR_HPP
+#define LML_C_ARRAY_PAR_HPP
+/*
+  c_array_par.hpp
+  ===============
+
+  Parallel loops over the elements, or rows, of large C arrays, plus
+  parallel array copy and comparison, run on the par::thread_pool.
+
+  Depends on <atomic>, <concepts>, <cstdint>, <cstring>, <numeric>,
+  "c_array_assign.hpp", "c_array_compare.hpp" and "thread_pool.hpp"
+
+  Usage
+  =====
+    static float grid[4096][4096];
+
+    lml::par::for_each(grid, [](float& v) { v *= 2; });   // flat order
+    lml::par::for_each_zip(grid, other, [](float& l, float r) { l += r; });
+    lml::par::for_each_row(grid, [](float (&row)[4096]) { ... });
+
+    lml::par::assign(grid) = other;         // multithreaded copy
+    lml::par::stream_assign(grid) = other;  // non-temporal stores
+
+    lml::par::equal_to{}(grid, other);           // as lml::equal_to
+    lml::par::compare_three_way{}(grid, other);  // as lml::compare...
+
+  The flat_size<A> index range (or the outer extent, for rows) is split
+  into chunks that start on cache-line boundaries of the flat array, so
+  no two threads write the same cache line of an aligned array. The
+  grain, the minimum chunk length, adapts to the array size: at least
+  min_chunk_bytes, and about eight chunks per thread for large arrays,
+  leaving work-stealing to balance the load.
+
+  Arrays smaller than serial_threshold_bytes are processed serially in
+  the calling thread, as are calls from within a parallel loop body.
+
+  The function is called concurrently, so must be safe to call from
+  multiple threads on distinct elements. The order of calls is
+  unspecified. An exception thrown by f is rethrown in the caller;
+  elements not yet visited may then be skipped.
+
+  par::assign(l) = r splits the copy in page-aligned chunks, so each
+  thread streams its own pages. Bulk copyable arrays (c_array_assign.hpp)
+  are copied as bytes, by memcpy. par::stream_assign(l) = r copies them
+  with non-temporal stores, where available (SSE2), so as not to evict
+  the caches for a destination too large to stay cached anyway; measure
+  first (bench/bench_par_assign.cpp), it's slower on some machines.
+  The max_threads argument, par::assign(l,max_threads), limits the
+  number of threads used.
+
+  par::equal_to and par::compare_three_way give the same results as the
+  serial lml functors. Chunks share an atomic first mismatch index, the
+  lowest found so far, and stop early once it is below their position;
+  chunks below it run on so the lowest mismatch is always found, which
+  alone decides the three-way result. equal_to stops all chunks at any
+  mismatch. Chunks check for cancellation every cancel_block elements.
+
+  These functions are not constexpr; use a plain loop, or std algorithms
+  on flat_cast(a), in constant evaluation.
+*/
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "c_array_assign.hpp"
+#include "c_array_compare.hpp"
+#include "thread_pool.hpp"
+
+#include "namespace.hpp"
+
+namespace par {
+
+inline constexpr std::size_t cache_line = 64;
+inline constexpr std::size_t page_size = 4096;
+
+// Arrays of fewer bytes than this are processed serially
+inline constexpr std::size_t serial_threshold_bytes = 1u << 18;
+
+// Chunks are no smaller than this, to amortize the scheduling cost
+inline constexpr std::size_t min_chunk_bytes = 1u << 14;
+
+// Comparison chunks check for cancellation every this many elements
+inline constexpr std::size_t cancel_block = 1024;
+
+namespace impl {
+
+// grain(units, unit_bytes, threads) chunk length, in units
+//
+inline std::size_t grain(std::size_t units, std::size_t unit_bytes,
+                         unsigned threads) noexcept
+{
+  auto least = (min_chunk_bytes + unit_bytes - 1) / unit_bytes;
+  auto even = units / (8 * std::size_t{threads});
+  return even > least ? even : least;
+}
+
+// for_chunks<Stride>(n, bytes, f, max_threads) calls f(begin,end) for
+//  chunks of the index range [0,n), with chunk boundaries on multiples
+//  of Stride, in parallel if the range covers serial_threshold_bytes
+//
+template <std::size_t Stride, typename F>
+void for_chunks(std::size_t n, std::size_t bytes, F&& f,
+                unsigned max_threads = 0)
+{
+  auto& pool = thread_pool::instance();
+  if (bytes < serial_threshold_bytes || pool.concurrency() == 1
+                         || max_threads == 1 || thread_pool::in_pool())
+  {
+    if (n != 0)
+      f(std::size_t{0}, n);
+    return;
+  }
+  auto units = (n + Stride - 1) / Stride;
+  pool.for_range(units, grain(units, bytes / units, pool.concurrency()),
+    [&](std::size_t b, std::size_t e) {
+      f(b * Stride, e * Stride < n ? e * Stride : n);
+    }, max_threads);
+}
+
+// line_stride<E> number of elements in a whole number of cache lines
+//
+template <typename E>
+inline constexpr std::size_t line_stride
+                           = std::lcm(sizeof(E), cache_line) / sizeof(E);
+
+// page_stride<E> number of elements in a whole number of pages
+//
+template <typename E>
+inline constexpr std::size_t page_stride
+                           = std::lcm(sizeof(E), page_size) / sizeof(E);
+
+// stream_copy(dst,src,n) memcpy by non-temporal stores, if available
+//
+inline void stream_copy(unsigned char* d, unsigned char const* s,
+                        std::size_t n) noexcept
+{
+#if defined(__SSE2__)
+  auto head = (16 - reinterpret_cast<std::uintptr_t>(d) % 16) % 16;
+  if (head > n)
+    head = n;
+  std::memcpy(d, s, head);
+  d += head, s += head, n -= head;
+  for (; n >= 64; d += 64, s += 64, n -= 64)
+  {
+    auto s0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s));
+    auto s1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 16));
+    auto s2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 32));
+    auto s3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d), s0);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), s1);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), s2);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), s3);
+  }
+  _mm_sfence();
+#endif
+  std::memcpy(d, s, n);
+}
+
+// first_mismatch<Stride,Any>(n, bytes, differ) returns the least index
+//  i < n for which differ(i), or n if none; if Any, returns any such i
+//
+template <std::size_t Stride, bool Any, typename Differ>
+std::size_t first_mismatch(std::size_t n, std::size_t bytes,
+                           Differ const& differ)
+{
+  std::atomic<std::size_t> first{n};
+  for_chunks<Stride>(n, bytes, [&](std::size_t i, std::size_t end) {
+    while (i != end)
+    {
+      auto found = first.load(std::memory_order_relaxed);
+      if (Any ? found != n : found <= i)
+        return;
+      auto stop = end - i > cancel_block ? i + cancel_block : end;
+      for (; i != stop; ++i)
+        if (differ(i))
+        {
+          while (i < found && ! first.compare_exchange_weak(found, i,
+                                               std::memory_order_relaxed));
+          return;
+        }
+    }
+  });
+  return first.load(std::memory_order_relaxed);
+}
+
+} // impl
+
+// for_each(a,f) calls f(e) for each element e of flattened array a
+//
+template <c_array A, typename F,
+          typename E = remove_all_extents_t<std::remove_reference_t<A>>>
+  requires std::invocable<F&, all_extents_removed_t<A&>>
+void for_each(A& a, F&& f)
+{
+  impl::for_chunks<impl::line_stride<E>>(flat_size<A>, sizeof(A),
+    [&](std::size_t i, std::size_t end) {
+      for (; i != end; ++i)
+        f(flat_index(a, i));
+    });
+}
+
+// for_each_zip(a,b,f) calls f(ea,eb) for each pair of elements at the
+//  same flat index of same-extent arrays a and b
+//
+template <c_array A, c_array B, typename F,
+          typename E = remove_all_extents_t<std::remove_reference_t<A>>>
+  requires same_extents<std::remove_cvref_t<A>, std::remove_cvref_t<B>>
+        && std::invocable<F&, all_extents_removed_t<A&>,
+                              all_extents_removed_t<B&>>
+void for_each_zip(A& a, B& b, F&& f)
+{
+  impl::for_chunks<impl::line_stride<E>>(flat_size<A>,
+                                         sizeof(A) + sizeof(B),
+    [&](std::size_t i, std::size_t end) {
+      for (; i != end; ++i)
+        f(flat_index(a, i), flat_index(b, i));
+    });
+}
+
+// for_each_row(a,f) calls f(a[r]) for each row r of a rank > 1 array a
+//
+template <c_array A, typename F>
+  requires (rank_v<std::remove_cvref_t<A>> > 1)
+        && std::invocable<F&, decltype(*std::declval<A&>())>
+void for_each_row(A& a, F&& f)
+{
+  impl::for_chunks<1>(std::extent_v<std::remove_cvref_t<A>>, sizeof(A),
+    [&](std::size_t r, std::size_t end) {
+      for (; r != end; ++r)
+        f(a[r]);
+    });
+}
+
+// compare_three_way functor, a parallel lml::compare_three_way for arrays
+//
+struct compare_three_way
+{
+  template <c_array L, c_array R,
+            typename E = remove_all_extents_t<std::remove_reference_t<L>>>
+    requires three_way_comparable_with<L,R>
+  auto operator()(L&& l, R&& r) const -> compare_three_way_result_t<L,R>
+  {
+    auto m = impl::first_mismatch<impl::line_stride<E>, false>(
+                                     flat_size<L>, sizeof l + sizeof r,
+      [&](std::size_t i) {
+        return std::compare_three_way{}(flat_index((L&&)l, i),
+                                        flat_index((R&&)r, i)) != 0;
+      });
+    if (m == flat_size<L>)
+      return compare_three_way_result_t<L,R>::equivalent;
+    return std::compare_three_way{}(flat_index((L&&)l, m),
+                                    flat_index((R&&)r, m));
+  }
+
+  template <c_array A>
+  auto operator()(A const& l, A const& r) const
+  {
+    return operator()<A const&, A const&>(l,r);
+  }
+
+  using is_transparent = void;
+};
+
+// equal_to functor, a parallel lml::equal_to for arrays
+//
+struct equal_to
+{
+  template <c_array L, c_array R,
+            typename E = remove_all_extents_t<std::remove_reference_t<L>>>
+    requires equality_comparable_with<L,R>
+  bool operator()(L&& l, R&& r) const
+  {
+    return impl::first_mismatch<impl::line_stride<E>, true>(
+                                  flat_size<L>, sizeof l + sizeof r,
+      [&](std::size_t i) {
+        return flat_index((L&&)l, i) != flat_index((R&&)r, i);
+      }) == flat_size<L>;
+  }
+
+  template <c_array A>
+  bool operator()(A const& l, A const& r) const
+  {
+    return operator()<A const&, A const&>(l,r);
+  }
+
+  using is_transparent = void;
+};
+
+// assign_to<L> reference wrapper for array L with operator= overloads
+//  that copy in parallel; returned by par::assign(l)
+//
+template <c_array L>
+struct assign_to
+{
+  L& l;
+  unsigned max_threads = 0;
+  bool streaming = false;
+
+  using value_type = std::remove_reference_t<L>;
+
+  template <c_array R>
+    requires assignable_from<L, R&&>
+  L& operator=(R&& r) const
+  {
+    copy((R&&)r);
+    return l;
+  }
+
+  L& operator=(value_type const& r) const
+  {
+    copy(r);
+    return l;
+  }
+
+ private:
+  template <typename R>
+  void copy(R&& r) const
+  {
+    if constexpr (bulk_copyable<L, R>)
+    {
+      if (static_cast<void const*>(&l) == static_cast<void const*>(&r))
+        return;
+      auto d = reinterpret_cast<unsigned char*>(&l);
+      auto s = reinterpret_cast<unsigned char const*>(&r);
+      impl::for_chunks<page_size>(sizeof l, 2 * sizeof l,
+        [&](std::size_t b, std::size_t e) {
+          if (streaming)
+            impl::stream_copy(d + b, s + b, e - b);
+          else
+            std::memcpy(d + b, s + b, e - b);
+        }, max_threads);
+    }
+    else
+    {
+      using E = remove_all_extents_t<value_type>;
+      impl::for_chunks<impl::page_stride<E>>(flat_size<L>,
+                                             sizeof l + sizeof r,
+        [&](std::size_t i, std::size_t end) {
+          for (; i != end; ++i)
+            flat_index(l, i) = flat_index((R&&)r, i);
+        }, max_threads);
+    }
+  }
+};
+
+// assign(l,max_threads) returns par::assign_to<L&>{l}, for a parallel
+//  copy by par::assign(l) = r
+//
+template <c_array L>
+  requires (! std::is_const_v<std::remove_reference_t<L>>)
+assign_to<L&> assign(L& l, unsigned max_threads = 0) noexcept
+{
+  return {l, max_threads};
+}
+
+// stream_assign(l,max_threads) as par::assign, with non-temporal stores
+//
+template <c_array L>
+  requires (! std::is_const_v<std::remove_reference_t<L>>)
+assign_to<L&> stream_assign(L& l, unsigned max_threads = 0) noexcept
+{
+  return {l, max_threads, true};
+}
+
+} // par
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_PAR_HPP
@@ -0,0 +1,350 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_PAR_SORT_HPP
+#define LML_C_ARRAY_PAR_SORT_HPP
+/*
+  c_array_par_sort.hpp
+  ====================
+
+  Parallel sort of the flattened elements of a C array, par::sort(a),
+  and of the rows of a nested array, par::sort_rows(a), on the
+  work-stealing par::thread_pool.
+
+  Depends on <algorithm>, <array>, <bit>, <iterator>, <memory>,
+  <utility>, "c_array_par.hpp" and "c_array_compare.hpp"
+
+  Usage
+  =====
+    static std::uint64_t keys[1 << 26];
+    lml::par::sort(keys);                  // ascending, by lml::less
+    lml::par::sort(keys, std::greater{});  // any strict weak order
+
+    static char names[1 << 20][16];
+    lml::par::sort_rows(names);            // rows ordered by lml::less
+
+  par::sort(a,comp) sorts flat_cast(a), so multidimensional arrays sort
+  in flat order. It is a parallel merge sort: the array is cut in runs,
+  a few per thread, each run sorted, then pairs of runs are merged level
+  by level into a buffer, and back, each merge level split evenly across
+  threads by merge-path co-ranking (binary search for the split points),
+  so all threads work on the last merge too. Arrays under
+  serial_threshold_bytes are a single run.
+
+  The leaves are sorting networks (Batcher's odd-even merge sort), fixed
+  sequences of compare-swaps: a run is sorted as blocks of network_max
+  elements, each by the network, then merged bottom up within the run.
+  Arrays of up to network_max elements are sorted by the network alone.
+  For trivially copyable elements of up to 16 bytes the compare-swaps
+  and merges select by the comparison, without branching on it.
+
+  Stability: par::sort is not stable (the networks). par::sort_rows is
+  stable; it sorts row indices by stable merges of std::stable_sort runs,
+  then permutes the rows, in parallel, through a buffer.
+
+  Comparisons: O(n log n); 63 compare-swaps per 16-element block (19 for
+  8 elements), then at most n per merge level, log2(n/16) levels, plus
+  the co-ranking searches, log2 n per split.
+
+  The buffer holds n elements, so elements must be default initializable
+  as well as move assignable and swappable. Not usable in constant
+  evaluation.
+*/
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "c_array_par.hpp"
+#include "c_array_compare.hpp"
+
+#include "namespace.hpp"
+
+namespace par {
+
+// Arrays of up to network_max elements are sorted by sorting network
+inline constexpr std::size_t network_max = 16;
+
+namespace impl {
+
+// batcher_network<N>() compare-swap index pairs of Batcher's odd-even
+//  merge sort for N elements; the network for bit_ceil(N) elements with
+//  comparators on padding indices >= N dropped (padding sorts last)
+//
+template <std::size_t N>
+constexpr auto batcher_network()
+{
+  constexpr std::size_t P = std::bit_ceil(N);
+  auto for_each_pair = [](auto&& f) {
+    for (std::size_t p = 1; p < P; p *= 2)
+      for (std::size_t k = p; k >= 1; k /= 2)
+        for (std::size_t j = k % p; j + k < P; j += 2 * k)
+          for (std::size_t i = 0; i < k && i < P - j - k; ++i)
+            if ((i + j) / (2 * p) == (i + j + k) / (2 * p)
+             && i + j + k < N)
+              f(i + j, i + j + k);
+  };
+  constexpr std::size_t count = [&] {
+    std::size_t c = 0;
+    for_each_pair([&](std::size_t, std::size_t) { ++c; });
+    return c;
+  }();
+  std::array<std::pair<unsigned char, unsigned char>, count> pairs{};
+  std::size_t c = 0;
+  for_each_pair([&](std::size_t a, std::size_t b) {
+    pairs[c++] = {static_cast<unsigned char>(a),
+                  static_cast<unsigned char>(b)};
+  });
+  return pairs;
+}
+
+// branch_free<E> compare-swaps and merges select E values by the
+//  comparison result, rather than branch on it, for small trivial E
+//
+template <typename E>
+inline constexpr bool branch_free = std::is_trivially_copyable_v<E>
+                                 && std::is_copy_constructible_v<E>
+                                 && std::is_copy_assignable_v<E>
+                                 && sizeof(E) <= 16;
+
+// network_sort<N>(p, comp) sorts [p,p+N) by batcher_network<N>
+//
+template <std::size_t N, typename E, typename Comp>
+void network_sort(E* p, Comp const& comp)
+{
+  static constexpr auto network = batcher_network<N>();
+  for (auto [a, b] : network)
+    if constexpr (branch_free<E>)
+    {
+      E x = p[a], y = p[b];
+      bool c = comp(y, x);
+      p[a] = c ? y : x;
+      p[b] = c ? x : y;
+    }
+    else if (comp(p[b], p[a]))
+      std::swap(p[a], p[b]);
+}
+
+// co_rank(d, a, la, b, lb, comp) number of elements of a among the first
+//  d elements of the stable merge of a and b (a first on ties)
+//
+template <typename E, typename Comp>
+std::size_t co_rank(std::size_t d, E const* a, std::size_t la,
+                    E const* b, std::size_t lb, Comp const& comp)
+{
+  std::size_t lo = d > lb ? d - lb : 0;
+  std::size_t hi = d < la ? d : la;
+  while (lo < hi)
+  {
+    auto i = lo + (hi - lo) / 2;
+    auto j = d - i;
+    if (j > 0 && i < la && ! comp(b[j - 1], a[i]))
+      lo = i + 1;
+    else
+      hi = i;
+  }
+  return lo;
+}
+
+// merge_runs(a, la, b, lb, d, comp) merges sorted [a,a+la) and [b,b+lb)
+//  into d, stably, as std::merge
+//
+template <typename E, typename Comp>
+void merge_runs(E* a, std::size_t la, E* b, std::size_t lb, E* d,
+                Comp const& comp)
+{
+  E* ae = a + la;
+  E* be = b + lb;
+  if constexpr (branch_free<E>)
+    while (a != ae && b != be)
+    {
+      bool c = comp(*b, *a);
+      *d++ = c ? *b : *a;
+      b += c;
+      a += ! c;
+    }
+  std::merge(std::make_move_iterator(a), std::make_move_iterator(ae),
+             std::make_move_iterator(b), std::make_move_iterator(be),
+             d, comp);
+}
+
+// merge_level(src, dst, n, width, begin, end, comp) writes output range
+//  [begin,end) of the merges of adjacent width-runs of src into dst
+//
+template <typename E, typename Comp>
+void merge_level(E* src, E* dst, std::size_t n, std::size_t width,
+                 std::size_t begin, std::size_t end, Comp const& comp)
+{
+  while (begin != end)
+  {
+    auto s = begin / (2 * width) * (2 * width);
+    auto mid = s + width < n ? s + width : n;
+    auto last = mid + width < n ? mid + width : n;
+    auto stop = end < last ? end : last;
+    auto a = src + s, b = src + mid;
+    auto la = mid - s, lb = last - mid;
+    auto i0 = co_rank(begin - s, a, la, b, lb, comp);
+    auto i1 = co_rank(stop - s, a, la, b, lb, comp);
+    merge_runs(a + i0, i1 - i0, b + (begin - s - i0),
+               (stop - s - i1) - (begin - s - i0), dst + begin, comp);
+    begin = stop;
+  }
+}
+
+// leaf_sort(p, n, buf, comp) sorts [p,p+n) by sorting networks on
+//  network_max blocks, then merges of the blocks via n elements of buf
+//
+template <typename E, typename Comp>
+void leaf_sort(E* p, std::size_t n, E* buf, Comp const& comp)
+{
+  std::size_t full = n / network_max * network_max;
+  for (std::size_t b = 0; b != full; b += network_max)
+    network_sort<network_max>(p + b, comp);
+  for (std::size_t i = full + 1; i < n; ++i)
+    for (std::size_t j = i; j != full && comp(p[j], p[j - 1]); --j)
+      std::swap(p[j], p[j - 1]);
+  E* src = p;
+  E* dst = buf;
+  for (std::size_t width = network_max; width < n; width *= 2)
+  {
+    for (std::size_t s = 0; s < n; s += 2 * width)
+    {
+      auto mid = s + width < n ? s + width : n;
+      auto last = mid + width < n ? mid + width : n;
+      merge_runs(src + s, mid - s, src + mid, last - mid, dst + s, comp);
+    }
+    std::swap(src, dst);
+  }
+  if (src != p)
+    std::move(src, src + n, p);
+}
+
+// run_sort<Stable>(p, n, buf, comp) sorts a run [p,p+n); stable runs
+//  by std::stable_sort, others by leaf_sort
+//
+template <bool Stable, typename E, typename Comp>
+void run_sort(E* p, std::size_t n, E* buf, Comp const& comp)
+{
+  if constexpr (Stable)
+    std::stable_sort(p, p + n, comp);
+  else
+    leaf_sort(p, n, buf, comp);
+}
+
+// merge_sort<Stable>(pool, p, n, comp) sorts [p,p+n) on the pool
+//
+template <bool Stable, typename E, typename Comp>
+void merge_sort(thread_pool& pool, E* p, std::size_t n, Comp const& comp)
+{
+  auto threads = pool.concurrency();
+  if (n * sizeof(E) < serial_threshold_bytes || threads == 1
+                                             || thread_pool::in_pool())
+  {
+    std::unique_ptr<E[]> buffer{Stable ? nullptr : new E[n]};
+    run_sort<Stable>(p, n, buffer.get(), comp);
+    return;
+  }
+  auto least = (min_chunk_bytes + sizeof(E) - 1) / sizeof(E);
+  auto runs = std::bit_ceil(std::size_t{threads}) * 4;
+  while (runs > 1 && n / runs < least)
+    runs /= 2;
+  auto width = (n + runs - 1) / runs;
+
+  std::unique_ptr<E[]> buffer{new E[n]};
+  pool.for_range(runs, 1, [&](std::size_t r, std::size_t end) {
+    for (; r != end; ++r)
+      if (r * width < n)
+        run_sort<Stable>(p + r * width,
+                         ((r + 1) * width < n ? width : n - r * width),
+                         buffer.get() + r * width, comp);
+  });
+  if (width >= n)
+    return;
+
+  E* src = p;
+  E* dst = buffer.get();
+  auto piece = grain(n, sizeof(E), threads);
+  for (; width < n; width *= 2)
+  {
+    pool.for_range(n, piece, [&](std::size_t b, std::size_t e) {
+      merge_level(src, dst, n, width, b, e, comp);
+    });
+    std::swap(src, dst);
+  }
+  if (src != p)
+    pool.for_range(n, piece, [&](std::size_t b, std::size_t e) {
+      std::move(src + b, src + e, p + b);
+    });
+}
+
+} // impl
+
+// sort(a,comp) sorts the flattened elements of array a by comp
+//
+template <c_array_unpadded A, typename Comp = less,
+          typename E = remove_all_extents_t<std::remove_reference_t<A>>>
+  requires (! std::is_const_v<E>)
+        && std::default_initializable<E> && std::is_move_assignable_v<E>
+        && std::swappable<E> && std::predicate<Comp const&, E&, E&>
+void sort(A& a, Comp const& comp = {})
+{
+  if constexpr (flat_size<A> > 1)
+  {
+    E* p = &flat_index(a);
+    if constexpr (flat_size<A> <= network_max)
+      impl::network_sort<flat_size<A>>(p, comp);
+    else
+      impl::merge_sort<false>(thread_pool::instance(), p,
+                              flat_size<A>, comp);
+  }
+}
+
+// sort_rows(a,comp) stable sort of the rows a[i] of array a by comp,
+//  lml::less by default
+//
+template <c_array A, typename Comp = less,
+          typename R = std::remove_extent_t<std::remove_reference_t<A>>>
+  requires (rank_v<std::remove_cvref_t<A>> > 1)
+        && (! std::is_const_v<std::remove_reference_t<A>>)
+        && std::default_initializable<remove_all_extents_t<R>>
+        && std::is_copy_assignable_v<remove_all_extents_t<R>>
+        && std::predicate<Comp const&, R const&, R const&>
+void sort_rows(A& a, Comp const& comp = {})
+{
+  constexpr std::size_t n = std::extent_v<std::remove_reference_t<A>>;
+  if constexpr (n > 1)
+  {
+    auto& pool = thread_pool::instance();
+    std::unique_ptr<std::size_t[]> index{new std::size_t[n]};
+    for (std::size_t i = 0; i != n; ++i)
+      index[i] = i;
+    impl::merge_sort<true>(pool, index.get(), n,
+      [&](std::size_t i, std::size_t j) { return comp(a[i], a[j]); });
+
+    std::unique_ptr<R[]> rows{new R[n]};
+    auto copy = [](R& l, R const& r) {
+      for (std::size_t i = 0; i != flat_size<R>; ++i)
+        flat_index(l, i) = flat_index(r, i);
+    };
+    auto bytes = 2 * n * sizeof(R);
+    impl::for_chunks<1>(n, bytes, [&](std::size_t b, std::size_t e) {
+      for (; b != e; ++b)
+        copy(rows[b], a[index[b]]);
+    });
+    impl::for_chunks<1>(n, bytes, [&](std::size_t b, std::size_t e) {
+      for (; b != e; ++b)
+        copy(a[b], rows[b]);
+    });
+  }
+}
+
+} // par
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_PAR_SORT_HPP
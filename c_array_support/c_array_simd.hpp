@@ -0,0 +1,395 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_SIMD_HPP
+#define LML_C_ARRAY_SIMD_HPP
+/*
+  c_array_simd.hpp
+  ================
+
+  Load and store of C arrays as SIMD values, and a chunked SIMD view of
+  a flattened array, on std::experimental::simd (Parallelism TS v2),
+  or GCC / Clang vector extensions where that's not available.
+
+  Depends on <bit>, <cstddef>, <cstring>, <iterator>, <memory>,
+  <experimental/simd> (if present), "c_array_support.hpp"
+  and "c_array_aligned.hpp"
+  (and is empty if the compiler has neither simd nor vector extensions)
+
+  Usage
+  =====
+    float a[8], b[8];
+    auto v = lml::simd_load(a);       // simd<float,8> of a's elements
+    lml::simd_store(b, v * 2);
+
+    float x[1000];
+    for (auto c : lml::simd_view(x))  // chunks of native width
+    {
+      auto v = c.load();              // lanes past the tail are zero
+      c.store(v * v + 1);             // stores only the valid lanes
+    }
+
+  Types:
+    lml::simd<T,N>        N lanes of T; stdx::fixed_size_simd<T,N>, or a
+                          vector extension type of bit_ceil(N) lanes
+    lml::native_simd<T>   the widest efficient vector of T
+    lml::simd_chunk<T,Align>  native_simd<T> sized piece of a simd_view
+    lml::simd_chunk_view<T,N,Align>  the range returned by simd_view
+
+  simd_load(a) and simd_store(a,v) take unpadded arrays of vectorizable
+  elements (arithmetic, not bool), multidimensional arrays as-if flat.
+  simd_view(a) iterates the flattened array in simd_chunk pieces of
+  native_simd<T>::size() lanes; only the last may be shorter, a masked
+  tail, for which load() zeros the lanes past the end and store(v) and
+  mask() cover the valid lanes only.
+
+  Alignment is deduced from the static type: loads and stores use the
+  alignment of the array type, alignof(A), which is the element's, or
+  the alignment of an lml::aligned_array (see c_array_aligned.hpp).
+
+  Backend: std::experimental::simd if __cpp_lib_experimental_parallel_simd
+  is defined, unless LML_SIMD_NO_STDX is defined; otherwise GCC vector
+  extensions (also supported by Clang), with native width 64, 32 or 16
+  bytes for AVX-512, AVX or other targets. Vector extension types have
+  a power of two lanes, so simd<T,N> has bit_ceil(N) lanes, zero padded;
+  GCC warns -Wpsabi where such values wider than the target's vectors
+  are passed or returned.
+  C++26 std::simd is not yet supported.
+*/
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+
+#if __has_include(<experimental/simd>) && ! defined(LML_SIMD_NO_STDX)
+#include <experimental/simd>
+#endif
+
+#if defined(__cpp_lib_experimental_parallel_simd) \
+ && ! defined(LML_SIMD_NO_STDX)
+#define LML_SIMD_STDX 1
+#elif defined(__GNUC__)
+#define LML_SIMD_VECTOR_EXT 1
+#endif
+
+#if defined(LML_SIMD_STDX) || defined(LML_SIMD_VECTOR_EXT)
+
+#include "c_array_support.hpp"
+#include "c_array_aligned.hpp"
+
+#include "namespace.hpp"
+
+// vectorizable<T> concept: T is a valid simd element type
+//
+template <typename T>
+concept vectorizable = std::is_arithmetic_v<T>
+                    && ! std::is_same_v<std::remove_cv_t<T>, bool>;
+
+// simd_array<A> concept: unpadded array of vectorizable elements
+//
+template <typename A>
+concept simd_array = c_array_unpadded<A>
+   && vectorizable<remove_all_extents_t<std::remove_reference_t<A>>>;
+
+#if defined(LML_SIMD_STDX)
+
+namespace impl {
+namespace stdx = std::experimental;
+
+// simd_flag<Align,T> the load / store flag for a T* known Align aligned
+//
+template <std::size_t Align, typename T>
+inline constexpr auto simd_flag = [] {
+  if constexpr (Align > alignof(T))
+    return stdx::overaligned<Align>;
+  else
+    return stdx::element_aligned;
+}();
+} // impl
+
+template <typename T, std::size_t N>
+using simd = std::experimental::fixed_size_simd<T, N>;
+
+template <typename T>
+using native_simd = std::experimental::native_simd<T>;
+
+#else // LML_SIMD_VECTOR_EXT
+
+// Wide vector returns change the ABI without AVX enabled; all inline
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace impl {
+
+#if defined(__AVX512F__)
+inline constexpr std::size_t simd_native_bytes = 64;
+#elif defined(__AVX__)
+inline constexpr std::size_t simd_native_bytes = 32;
+#else
+inline constexpr std::size_t simd_native_bytes = 16;
+#endif
+
+template <typename T, std::size_t N>
+struct vector_ext
+{
+  static constexpr std::size_t bytes = std::bit_ceil(N) * sizeof(T);
+  typedef T type __attribute__((vector_size(bytes)));
+};
+} // impl
+
+template <typename T, std::size_t N>
+using simd = typename impl::vector_ext<T, N>::type;
+
+template <typename T>
+using native_simd = simd<T, impl::simd_native_bytes / sizeof(T)>;
+
+#endif
+
+namespace impl {
+
+// lanes<V>() the number of lanes of simd type V; lane_t<V> their type
+//
+#if defined(LML_SIMD_STDX)
+template <typename V>
+constexpr std::size_t lanes() { return V::size(); }
+
+template <typename V>
+using lane_t = typename V::value_type;
+#else
+template <typename V>
+using lane_t = std::remove_cvref_t<decltype(V{}[0])>;
+
+template <typename V>
+constexpr std::size_t lanes() { return sizeof(V) / sizeof(lane_t<V>); }
+#endif
+
+// lane_mask<V>(n) mask of the first n lanes of simd type V
+//
+template <typename V>
+auto lane_mask(std::size_t n) noexcept
+{
+  using T = lane_t<V>;
+#if defined(LML_SIMD_STDX)
+  V iota([](auto i) { return T(i); });
+#else
+  V iota{};
+  for (std::size_t i = 0; i != lanes<V>(); ++i)
+    iota[i] = T(i);
+#endif
+  return iota < T(n);
+}
+
+// simd_load_n<V,Align>(p,n) n <= lanes elements at p, zero padded
+//
+template <typename V, std::size_t Align, typename T>
+V simd_load_n(T const* p, std::size_t n) noexcept
+{
+  V v{};
+#if defined(LML_SIMD_STDX)
+  if (n == lanes<V>())
+    v.copy_from(p, simd_flag<Align, T>);
+  else
+    stdx::where(lane_mask<V>(n), v).copy_from(p, stdx::element_aligned);
+#else
+  std::memcpy(&v, std::assume_aligned<Align>(p), n * sizeof(T));
+#endif
+  return v;
+}
+
+// simd_store_n<Align>(p,v,n) stores the first n lanes of v at p
+//
+template <std::size_t Align, typename T, typename V>
+void simd_store_n(T* p, V const& v, std::size_t n) noexcept
+{
+#if defined(LML_SIMD_STDX)
+  if (n == lanes<V>())
+    v.copy_to(p, simd_flag<Align, T>);
+  else
+    stdx::where(lane_mask<V>(n), v).copy_to(p, stdx::element_aligned);
+#else
+  std::memcpy(std::assume_aligned<Align>(p), &v, n * sizeof(T));
+#endif
+}
+
+} // impl
+
+// simd_load(a) the elements of array a as a simd<T,flat_size<A>> value
+//
+template <simd_array A,
+          typename T = std::remove_cv_t<remove_all_extents_t<A>>>
+simd<T, flat_size<A>> simd_load(A const& a) noexcept
+{
+  return impl::simd_load_n<simd<T, flat_size<A>>, alignof(A)>(
+                                           &flat_index(a), flat_size<A>);
+}
+
+// simd_store(a,v) stores the lanes of v, a simd_load(a) type, in a
+//
+template <simd_array A, typename T = remove_all_extents_t<A>>
+  requires (! std::is_const_v<T>)
+void simd_store(A& a, simd<T, flat_size<A>> const& v) noexcept
+{
+  impl::simd_store_n<alignof(A)>(&flat_index(a), v, flat_size<A>);
+}
+
+// simd_chunk<T,Align> up to native_simd<T>::size() elements at data,
+//  Align aligned; size() is less only for the tail chunk of a view
+//
+template <typename T, std::size_t Align>
+class simd_chunk
+{
+ public:
+  using value_type = std::remove_const_t<T>;
+  using simd_type = native_simd<value_type>;
+
+  static constexpr std::size_t width = impl::lanes<simd_type>();
+
+  constexpr simd_chunk(T* p, std::size_t n) noexcept : p(p), n(n) {}
+
+  constexpr T* data() const noexcept { return p; }
+  constexpr std::size_t size() const noexcept { return n; }
+  constexpr bool full() const noexcept { return n == width; }
+
+  // load() the elements as a simd value; lanes past size() are zero
+  //
+  simd_type load() const noexcept
+  {
+    return impl::simd_load_n<simd_type, Align>(p, n);
+  }
+
+  // store(v) stores the first size() lanes of v
+  //
+  void store(simd_type const& v) const noexcept
+    requires (! std::is_const_v<T>)
+  {
+    impl::simd_store_n<Align>(p, v, n);
+  }
+
+  // mask() true in the first size() lanes
+  //
+  auto mask() const noexcept { return impl::lane_mask<simd_type>(n); }
+
+ private:
+  T* p;
+  std::size_t n;
+};
+
+// simd_chunk_view<T,N,Align> the N elements at a pointer as simd_chunks
+//
+template <typename T, std::size_t N, std::size_t Align>
+class simd_chunk_view
+{
+ public:
+  using chunk = simd_chunk<T, Align>;
+
+  static constexpr std::size_t width = chunk::width;
+
+  class iterator
+  {
+   public:
+    using value_type = chunk;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    constexpr iterator(T* p, std::size_t n) noexcept : p(p), n(n) {}
+
+    constexpr chunk operator*() const noexcept
+    {
+      return {p, n < width ? n : width};
+    }
+
+    constexpr iterator& operator++() noexcept
+    {
+      auto step = n < width ? n : width;
+      p += step;
+      n -= step;
+      return *this;
+    }
+
+    constexpr iterator operator++(int) noexcept
+    {
+      auto i = *this;
+      ++*this;
+      return i;
+    }
+
+    friend constexpr bool operator==(iterator const& i,
+                                     std::default_sentinel_t) noexcept
+    {
+      return i.n == 0;
+    }
+
+   private:
+    T* p = nullptr;
+    std::size_t n = 0;
+  };
+
+  constexpr explicit simd_chunk_view(T* p) noexcept : p(p) {}
+
+  constexpr iterator begin() const noexcept { return {p, N}; }
+  constexpr std::default_sentinel_t end() const noexcept { return {}; }
+
+  // size() the number of chunks
+  //
+  static constexpr std::size_t size() noexcept
+  {
+    return (N + width - 1) / width;
+  }
+
+ private:
+  T* p;
+};
+
+// simd_view(a) view of array a, flattened, as native_simd sized chunks;
+//  chunks are aligned as the array type, at most a whole vector
+//
+template <simd_array A, std::size_t Align = alignof(A),
+          typename T = remove_all_extents_t<A>>
+auto simd_view(A& a) noexcept
+{
+  constexpr std::size_t vec = sizeof(native_simd<std::remove_const_t<T>>);
+  constexpr std::size_t align = Align < vec ? Align : vec;
+  return simd_chunk_view<T, flat_size<A>, align>(&flat_index(a));
+}
+
+// simd_load(a), simd_store(a,v) and simd_view(a) of an aligned_array
+//  of vectorizable elements, using its alignment
+//
+template <aligned_array_type A, typename D = typename A::array_type>
+  requires simd_array<D>
+auto simd_load(A const& a) noexcept
+{
+  using T = std::remove_cv_t<remove_all_extents_t<D>>;
+  return impl::simd_load_n<simd<T, flat_size<D>>, A::alignment>(
+                                      &flat_index(a.data), flat_size<D>);
+}
+
+template <aligned_array_type A, typename D = typename A::array_type,
+          typename T = remove_all_extents_t<D>>
+  requires simd_array<D> && (! std::is_const_v<T>)
+void simd_store(A& a, simd<T, flat_size<D>> const& v) noexcept
+{
+  impl::simd_store_n<A::alignment>(&flat_index(a.data), v, flat_size<D>);
+}
+
+template <aligned_array_type A>
+  requires simd_array<typename std::remove_const_t<A>::array_type>
+auto simd_view(A& a) noexcept
+{
+  return simd_view<std::remove_reference_t<decltype((a.data))>,
+                   std::remove_const_t<A>::alignment>(a.data);
+}
+
+#if defined(LML_SIMD_VECTOR_EXT)
+#pragma GCC diagnostic pop
+#endif
+
+#include "namespace.hpp"
+
+#endif // LML_SIMD_STDX || LML_SIMD_VECTOR_EXT
+
+#endif // LML_C_ARRAY_SIMD_HPP
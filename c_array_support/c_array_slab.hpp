@@ -0,0 +1,216 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_SLAB_HPP
+#define LML_C_ARRAY_SLAB_HPP
+/*
+  c_array_slab.hpp
+  ================
+
+  array_slab<A> is a per-type slab allocator for arrays of type A, for
+  programs that allocate and free many same-typed arrays, at high rates
+  from many threads, where new[] / malloc becomes a bottleneck.
+
+  Depends on <memory>, <mutex>, <new>, <vector> and "c_array_support.hpp"
+
+  Usage
+  =====
+    float (&buf)[64] = lml::array_slab<float[64]>::allocate();
+    ...
+    lml::array_slab<float[64]>::deallocate(buf);
+
+  Slots are cache-line aligned, of sizeof(A) rounded up to a multiple of
+  the slot alignment, so no two arrays share a cache line. Slots are
+  carved from slabs of at least 64KiB and are never returned to the OS.
+
+  Each thread keeps a local free list, so allocate and deallocate are
+  lock-free in the common case. Free slots move between the threads'
+  lists and a global pool in batches of BatchSize, under a mutex, when a
+  local list runs empty or grows beyond two batches; on thread exit all
+  of its free slots return to the global pool.
+
+  allocate() default-initializes the array elements (as new A does) and
+  deallocate(a) destroys them. For zero-size A no storage is allocated;
+  allocate() returns a reference to a shared zero-size array.
+*/
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "c_array_support.hpp"
+
+#include "namespace.hpp"
+
+// array_slab<A,BatchSize> slab allocator for arrays of type A
+//
+template <c_array A, std::size_t BatchSize = 64>
+  requires (! std::is_reference_v<A> && ! std::is_const_v<A>
+         && std::is_default_constructible_v<remove_all_extents_t<A>>
+         && BatchSize != 0)
+class array_slab
+{
+ public:
+  using value_type = A;
+
+  static constexpr std::size_t cache_line = 64;
+  static constexpr std::size_t slot_align = alignof(A) > cache_line
+                                          ? alignof(A) : cache_line;
+  static constexpr std::size_t slot_size = flat_size<A> == 0 ? 0
+                   : (sizeof(A) + slot_align - 1) / slot_align * slot_align;
+  static constexpr std::size_t slab_slots = slot_size == 0 ? 0
+                   : slot_size * BatchSize >= 0x10000 ? BatchSize
+                   : (0x10000 / slot_size + BatchSize - 1)
+                                          / BatchSize * BatchSize;
+
+  // allocate() returns a default-initialized array in a fresh slot
+  //
+  static A& allocate()
+  {
+    if constexpr (slot_size == 0)
+    {
+      static A&& none = {};
+      return none;
+    }
+    else
+    {
+      auto& cache = local();
+      if (cache.head == nullptr)
+        cache.refill();
+      node* n = cache.head;
+      cache.head = n->next;
+      --cache.count;
+
+      using E = remove_all_extents_t<A>;
+      if constexpr (! std::is_trivially_default_constructible_v<E>)
+      {
+        auto e = reinterpret_cast<E*>(n);
+        for (std::size_t i = 0; i != flat_size<A>; ++i)
+          ::new (static_cast<void*>(e + i)) E;
+      }
+      return *std::launder(reinterpret_cast<A*>(n));
+    }
+  }
+
+  // deallocate(a) destroys the elements of a and frees its slot
+  //
+  static void deallocate(A& a) noexcept
+  {
+    if constexpr (slot_size != 0)
+    {
+      std::destroy_at(&a);
+      auto& cache = local();
+      cache.head = ::new (static_cast<void*>(&a)) node{cache.head};
+      if (++cache.count >= 2 * BatchSize)
+        cache.spill();
+    }
+  }
+
+ private:
+  struct node { node* next; };
+
+  // batch, a null-terminated free list of up to BatchSize slots
+  //
+  struct batch { node* head; std::size_t count; };
+
+  // global free pool of batches, plus all slabs
+  //
+  struct global_pool
+  {
+    std::mutex mutex;
+    std::vector<batch> batches;
+    std::vector<void*> slabs;
+
+    ~global_pool()
+    {
+      for (auto s : slabs)
+        ::operator delete(s, std::align_val_t{slot_align});
+    }
+
+    // take() returns a batch of free slots, carving a new slab if needed
+    //
+    batch take()
+    {
+      std::lock_guard lock{mutex};
+      if (batches.empty())
+      {
+        auto slab = static_cast<unsigned char*>(::operator new(
+                    slab_slots * slot_size, std::align_val_t{slot_align}));
+        slabs.push_back(slab);
+        for (std::size_t b = 0; b != slab_slots; b += BatchSize)
+        {
+          node* head = nullptr;
+          for (auto i = b + BatchSize; i-- != b;)
+            head = ::new (slab + i * slot_size) node{head};
+          batches.push_back({head, BatchSize});
+        }
+      }
+      batch b = batches.back();
+      batches.pop_back();
+      return b;
+    }
+
+    void give(batch b)
+    {
+      std::lock_guard lock{mutex};
+      batches.push_back(b);
+    }
+  };
+
+  // thread local free list, moving batches to and from the global pool
+  //
+  struct local_cache
+  {
+    node* head = nullptr;
+    std::size_t count = 0;
+
+    void refill()
+    {
+      auto b = global().take();
+      head = b.head;
+      count = b.count;
+    }
+
+    // spill() gives a batch to the global pool, keeping one batch
+    //
+    void spill()
+    {
+      node* first = head;
+      node* last = head;
+      for (std::size_t i = 1; i != BatchSize; ++i)
+        last = last->next;
+      head = last->next;
+      last->next = nullptr;
+      count -= BatchSize;
+      global().give({first, BatchSize});
+    }
+
+    ~local_cache()
+    {
+      while (count >= BatchSize)
+        spill();
+      if (count != 0)
+        global().give({head, count});
+    }
+  };
+
+  static global_pool& global()
+  {
+    static global_pool pool;
+    return pool;
+  }
+
+  static local_cache& local()
+  {
+    global();  // constructed first, so destroyed after local caches
+    thread_local local_cache cache;
+    return cache;
+  }
+};
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_SLAB_HPP
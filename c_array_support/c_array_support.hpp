@@ -53,6 +53,11 @@
   - flat_cast(a) returns flattened 1D array, preserving cvref quals
   - subscript(a,i): returns a[i], an rvalue if 'a' is an rvalue
   - flat_index(a,i=0): returns element at i in flat_cast(a)
+
+ Declared here, defined in c_array_bounded.hpp, so that the functor
+ headers can accept bounded_arrays without including it:
+  - bounded_array<T>: runtime-bounded array view class template
+  - bounded_array_type<B>: matches bounded_array, under cvref
 */
 
 #include "util_traits.hpp"
@@ -294,6 +299,24 @@ constexpr auto flat_index(A&& a, Int i = 0) noexcept
     return mover(flat_cast(a)[i]); // No bounds check
 }
 
+// bounded_array<T> declaration; defined in c_array_bounded.hpp
+//
+template <typename T>
+  requires (std::is_object_v<T> && ! std::is_unbounded_array_v<T>)
+class bounded_array;
+
+namespace impl {
+template <typename>
+inline constexpr bool is_bounded_array = false;
+template <typename T>
+inline constexpr bool is_bounded_array<bounded_array<T>> = true;
+} // impl
+
+// bounded_array_type<B> concept: B is a bounded_array, under cvref
+//
+template <typename B>
+concept bounded_array_type = impl::is_bounded_array<std::remove_cvref_t<B>>;
+
 #include "namespace.hpp"
 
 #endif // LML_C_ARRAY_SUPPORT_HPP
@@ -0,0 +1,204 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_C_ARRAY_TRACKED_HPP
+#define LML_C_ARRAY_TRACKED_HPP
+/*
+  c_array_tracked.hpp
+  ===================
+
+  tracked_array<A,ChunkBytes> wraps a reference to a C array and records
+  which chunks of its bytes are modified through its mutation API, in a
+  bitmap with one bit per chunk (a cache line, 64 bytes, by default).
+  flush(sink) then hands the modified bytes to a sink as coalesced runs,
+  for incremental persistence or sync, without comparing whole arrays.
+
+  Depends on "c_array_assign.hpp" and "dirty_bits.hpp"
+
+  Usage
+  =====
+    float grid[1024][1024];
+    lml::tracked_array t{grid};
+
+    t.set(5, 1.f);               // element write by flat index
+    t.write(6) += 1.f;           // reference to element, marks dirty
+    t.assign_row(7, grid[8]);    // row assign, for rank > 1 arrays
+    t.assign(1000, {1.f,2.f});   // assign a subrange from flat index
+    t.assign(other_grid);        // assign all
+
+    float const(&g)[1024][1024] = t; // reads are plain A const&
+
+    t.flush([](std::size_t offset, unsigned char const* p,
+               std::size_t n) { write_at(offset, p, n); });
+
+  The cost per tracked write is one bit-set. Adjacent dirty chunks are
+  coalesced, so a run of writes flushes as one large write. The last
+  chunk may be short. Writes via writable() are untracked and must be
+  recorded with mark_dirty(first,count) or mark_all_dirty().
+*/
+
+#include "c_array_assign.hpp"
+#include "dirty_bits.hpp"
+
+#include "namespace.hpp"
+
+// tracked_array<A,ChunkBytes> reference wrapper for array A, tracking
+//  modified chunks of ChunkBytes size
+//
+template <c_array_unpadded A, std::size_t ChunkBytes = 64>
+  requires (! std::is_reference_v<A>
+         && std::is_trivially_copyable_v<remove_all_extents_t<A>>
+         && ChunkBytes != 0
+         && ChunkBytes % sizeof(remove_all_extents_t<A>) == 0)
+class tracked_array
+{
+ public:
+  using value_type = A;
+  using element_type = remove_all_extents_t<A>;
+
+  static constexpr std::size_t chunk_bytes = ChunkBytes;
+  static constexpr std::size_t chunk_size = ChunkBytes
+                                          / sizeof(element_type);
+  static constexpr std::size_t chunk_count = (flat_size<A> + chunk_size
+                                                 - 1) / chunk_size;
+
+  explicit tracked_array(A& a) : arr(a) {}
+
+  // Read access, the wrapped array by const reference
+  //
+  A const& get() const noexcept { return arr; }
+  operator A const&() const noexcept { return arr; }
+
+  element_type const& operator[](std::size_t i) const noexcept
+  {
+    return flat_index(arr, i);
+  }
+
+  // Tracked writes, by flat index
+  //
+  template <typename V>
+    requires std::is_assignable_v<element_type&, V&&>
+  void set(std::size_t i, V&& v)
+  {
+    flat_index(arr, i) = (V&&)v;
+    dirty.set(i / chunk_size);
+  }
+
+  element_type& write(std::size_t i) noexcept
+  {
+    dirty.set(i / chunk_size);
+    return flat_index(arr, i);
+  }
+
+  // assign_row(r,v) assigns row arr[r] of a rank > 1 array
+  //
+  template <typename R>
+    requires (rank_v<A> > 1)
+          && requires (A& l, R&& r) { assign_to<decltype(*l)>{*l} = (R&&)r; }
+  void assign_row(std::size_t r, R&& v)
+  {
+    assign_to<decltype(*arr)>{arr[r]} = (R&&)v;
+    mark_dirty(r * flat_size<decltype(*arr)>, flat_size<decltype(*arr)>);
+  }
+
+  void assign_row(std::size_t r, remove_extent_t<A> const& v)
+    requires (rank_v<A> > 1)
+  {
+    assign_row<remove_extent_t<A> const&>(r, v);
+  }
+
+  // assign(first,src) assigns flat elements from first, for the extent
+  //  of the flattened src array
+  //
+  template <c_array R>
+    requires std::is_assignable_v<element_type&,
+                                  all_extents_removed_t<R const&>>
+  void assign(std::size_t first, R const& src)
+  {
+    for (std::size_t i = 0; i != flat_size<R>; ++i)
+      flat_index(arr, first + i) = flat_index(src, i);
+    mark_dirty(first, flat_size<R>);
+  }
+
+  template <std::size_t N>
+  void assign(std::size_t first, element_type const(&src)[N])
+  {
+    assign<element_type[N]>(first, src);
+  }
+
+  // assign(r) assigns all elements
+  //
+  template <typename R>
+    requires requires (A& l, R&& r) { assign_to<A&>{l} = (R&&)r; }
+  void assign(R&& r)
+  {
+    assign_to<A&>{arr} = (R&&)r;
+    mark_all_dirty();
+  }
+
+  void assign(A const& r)
+  {
+    assign_to<A&>{arr} = r;
+    mark_all_dirty();
+  }
+
+  // Untracked write access; modified elements must be marked dirty
+  //
+  A& writable() noexcept { return arr; }
+
+  void mark_dirty(std::size_t first, std::size_t count) noexcept
+  {
+    if (count != 0)
+      dirty.set_range(first / chunk_size,
+                      (first + count - 1) / chunk_size + 1);
+  }
+
+  void mark_all_dirty() noexcept { dirty.set_all(); }
+
+  bool is_dirty(std::size_t chunk) const noexcept
+  {
+    return dirty.test(chunk);
+  }
+
+  bool modified() const noexcept { return dirty.any(); }
+
+  // for_each_dirty_range(f) calls f(offset,bytes) for each coalesced run
+  //  of dirty chunks, as a byte offset and byte count, in offset order
+  //
+  template <typename F>
+  void for_each_dirty_range(F&& f) const
+  {
+    dirty.for_each_run([&](std::size_t first, std::size_t last) {
+      auto offset = first * ChunkBytes;
+      auto end = last * ChunkBytes < sizeof(A) ? last * ChunkBytes
+                                                : sizeof(A);
+      f(offset, end - offset);
+    });
+  }
+
+  // flush(sink) calls sink(offset, bytes, count) for each dirty range,
+  //  passing a pointer to the array bytes, then clears all dirty marks
+  //
+  template <typename Sink>
+  void flush(Sink&& sink)
+  {
+    auto bytes = reinterpret_cast<unsigned char const*>(&arr);
+    for_each_dirty_range([&](std::size_t offset, std::size_t n) {
+      sink(offset, bytes + offset, n);
+    });
+    dirty.clear();
+  }
+
+ private:
+  A& arr;
+  dirty_bits dirty = dirty_bits(chunk_count);
+};
+
+template <c_array_unpadded A>
+tracked_array(A&) -> tracked_array<A>;
+
+#include "namespace.hpp"
+
+#endif // LML_C_ARRAY_TRACKED_HPP
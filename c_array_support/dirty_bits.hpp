@@ -0,0 +1,160 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_DIRTY_BITS_HPP
+#define LML_DIRTY_BITS_HPP
+/*
+  dirty_bits.hpp
+  ==============
+
+  A bitmap for change tracking, one bit per tracked block, used by
+  tracked_array (c_array_tracked.hpp) and block_hashed
+  (c_array_block_hash.hpp) to record modified blocks.
+
+  Depends on <bit>, <cstdint>, <utility> and <vector>
+
+  Class:
+
+    lml::dirty_bits            a bitmap of n bits, all clear
+
+  Member functions:
+
+    set(i), test(i)            set, or test, bit i
+    set_range(first,last)      set bits [first,last), word by word
+    set_all(), clear()         set, or clear, every bit
+    any(), count()             whether any bit is set, how many are
+    for_each_set(f)            calls f(i) for each set bit i
+    for_each_run(f)            calls f(first,last) for each run of set bits
+
+  Usage
+  =====
+    lml::dirty_bits d(1000);
+    d.set(3);
+    d.set_range(64, 130);
+    d.for_each_run([](std::size_t first, std::size_t last) {
+      flush(first, last);        // [3,4) then [64,130)
+    });
+    d.clear();
+
+  set(i) is a single bit-set, no counting, so cheap enough to call on
+  every tracked write. Scans are by 64-bit word, skipping clean words;
+  for_each_run coalesces runs across word bounds.
+*/
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "namespace.hpp"
+
+// dirty_bits bitmap for change tracking wrappers, one bit per
+//  tracked block
+//
+class dirty_bits
+{
+  std::vector<std::uint64_t> words;
+  std::size_t bits = 0;
+
+ public:
+  dirty_bits() = default;
+  explicit dirty_bits(std::size_t n) : words((n + 63) / 64), bits(n) {}
+
+  std::size_t size() const noexcept { return bits; }
+
+  void set(std::size_t i) noexcept
+  {
+    words[i / 64] |= std::uint64_t{1} << i % 64;
+  }
+
+  bool test(std::size_t i) const noexcept
+  {
+    return words[i / 64] >> i % 64 & 1u;
+  }
+
+  // set_range(first,last) sets bits [first,last) word by word
+  //
+  void set_range(std::size_t first, std::size_t last) noexcept
+  {
+    if (first >= last)
+      return;
+    auto fw = first / 64, lw = (last - 1) / 64;
+    auto fmask = ~std::uint64_t{} << first % 64;
+    auto lmask = ~std::uint64_t{} >> (63 - (last - 1) % 64);
+    if (fw == lw)
+      words[fw] |= fmask & lmask;
+    else {
+      words[fw] |= fmask;
+      for (auto w = fw + 1; w != lw; ++w)
+        words[w] = ~std::uint64_t{};
+      words[lw] |= lmask;
+    }
+  }
+
+  void set_all() noexcept { set_range(0, bits); }
+
+  void clear() noexcept
+  {
+    for (auto& w : words)
+      w = 0;
+  }
+
+  bool any() const noexcept
+  {
+    for (auto w : words)
+      if (w != 0)
+        return true;
+    return false;
+  }
+
+  std::size_t count() const noexcept
+  {
+    std::size_t n = 0;
+    for (auto w : words)
+      n += std::popcount(w);
+    return n;
+  }
+
+  // for_each_set(f) calls f(i) for each set bit i, in increasing order
+  //
+  template <typename F>
+  void for_each_set(F&& f) const
+  {
+    for (std::size_t w = 0; w != words.size(); ++w)
+      for (auto b = words[w]; b != 0; b &= b - 1)
+        f(w * 64 + std::countr_zero(b));
+  }
+
+  // for_each_run(f) calls f(first,last) for each maximal run of set bits
+  //  [first,last), in increasing order, coalescing across word bounds
+  //
+  template <typename F>
+  void for_each_run(F&& f) const
+  {
+    std::size_t first = 0;
+    bool in_run = false;
+    for (std::size_t w = 0; w != words.size(); ++w)
+    {
+      for (int i = 0; i != 64;)
+      {
+        auto rest = (in_run ? ~words[w] : words[w]) >> i;
+        if (rest == 0)
+          break;
+        i += std::countr_zero(rest);
+        if (in_run)
+          f(first, w * 64 + i);
+        else
+          first = w * 64 + i;
+        in_run = !in_run;
+      }
+    }
+    if (in_run)
+      f(first, bits);
+  }
+};
+
+#include "namespace.hpp"
+
+#endif // LML_DIRTY_BITS_HPP
@@ -0,0 +1,350 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+#ifndef LML_THREAD_POOL_HPP
+#define LML_THREAD_POOL_HPP
+/*
+  thread_pool.hpp
+  ===============
+
+  A small dependency-free work-stealing thread pool for fork-join loops
+  over an index range; the engine behind the lml::par algorithms.
+
+  Depends on <atomic>, <condition_variable>, <cstdint>, <exception>,
+  <mutex>, <thread>, <type_traits> and <vector>
+
+  Usage
+  =====
+    lml::par::thread_pool::instance().for_range(n, grain,
+      [&](std::size_t begin, std::size_t end) { ... });
+
+  for_range(n,grain,f) calls f(begin,end) on disjoint subranges covering
+  [0,n), each at least grain long (except the tail), from the calling
+  thread and the pool's workers, and returns when all calls are done.
+  The first exception thrown by f is rethrown in the calling thread.
+
+  Each participating thread owns a Chase-Lev work-stealing deque of
+  subranges. A thread splits its range in half, pushing the upper half
+  on its own deque, until the range is at most grain long; then it runs
+  f on it and pops its next range from the bottom of its deque. Idle
+  threads steal from the top of the other deques, taking the largest
+  outstanding ranges first. So the load balances adaptively, with few
+  steals when the work per index is uniform.
+
+  One loop runs at a time; for_range calls from other threads wait.
+  A for_range call from within f runs serially, in the calling thread.
+
+  The pool is created on first use, with hardware_concurrency() - 1
+  worker threads; the calling thread makes up the last participant.
+  Workers sleep on a condition variable between loops.
+
+  The deques use seq_cst operations on top and bottom in place of the
+  fences of Le et al., "Correct and Efficient Work-Stealing for Weak
+  Memory Models", PPoPP 2013; a negligible cost per chunk.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "namespace.hpp"
+
+namespace par {
+
+namespace impl {
+
+// range_deque Chase-Lev work-stealing deque of [begin,end) ranges,
+//  bounded; by binary splitting a thread pushes at most log2(n) ranges
+//
+class range_deque
+{
+ public:
+  static constexpr std::int64_t capacity = 128;
+
+  struct range { std::size_t begin, end; };
+
+  void reset() noexcept
+  {
+    top.store(0, std::memory_order_relaxed);
+    bottom.store(0, std::memory_order_relaxed);
+  }
+
+  // push(r) by the owner; returns false if full
+  //
+  bool push(range r) noexcept
+  {
+    auto b = bottom.load(std::memory_order_relaxed);
+    auto t = top.load(std::memory_order_acquire);
+    if (b - t >= capacity)
+      return false;
+    auto& slot = slots[b % capacity];
+    slot.begin.store(r.begin, std::memory_order_relaxed);
+    slot.end.store(r.end, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  // pop(r) by the owner, from the bottom; returns false if empty
+  //
+  bool pop(range& r) noexcept
+  {
+    auto b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_seq_cst);
+    auto t = top.load(std::memory_order_seq_cst);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    r = load(b);
+    if (t == b) {
+      bool won = top.compare_exchange_strong(t, t + 1,
+                     std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  // steal(r) by any thread, from the top; returns false if empty or lost
+  //
+  bool steal(range& r) noexcept
+  {
+    auto t = top.load(std::memory_order_seq_cst);
+    auto b = bottom.load(std::memory_order_seq_cst);
+    if (t >= b)
+      return false;
+    r = load(t);
+    return top.compare_exchange_strong(t, t + 1,
+                     std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+ private:
+  struct slot_t { std::atomic<std::size_t> begin, end; };
+
+  alignas(64) std::atomic<std::int64_t> top{0};
+  alignas(64) std::atomic<std::int64_t> bottom{0};
+  alignas(64) slot_t slots[capacity];
+
+  range load(std::int64_t i) const noexcept
+  {
+    auto& slot = slots[i % capacity];
+    return {slot.begin.load(std::memory_order_relaxed),
+            slot.end.load(std::memory_order_relaxed)};
+  }
+};
+
+} // impl
+
+// thread_pool work-stealing pool for parallel loops over index ranges
+//
+class thread_pool
+{
+ public:
+  explicit thread_pool(unsigned workers)
+    : deques(workers + 1)
+  {
+    threads.reserve(workers);
+    for (unsigned w = 1; w <= workers; ++w)
+      threads.emplace_back([this, w] { work(w); });
+  }
+
+  ~thread_pool()
+  {
+    {
+      std::lock_guard lock{mutex};
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads)
+      t.join();
+  }
+
+  thread_pool(thread_pool const&) = delete;
+  thread_pool& operator=(thread_pool const&) = delete;
+
+  // instance() the process-wide pool, created on first use
+  //
+  static thread_pool& instance()
+  {
+    static thread_pool pool{std::thread::hardware_concurrency() > 1
+                          ? std::thread::hardware_concurrency() - 1 : 0};
+    return pool;
+  }
+
+  // concurrency() number of threads that participate in a loop
+  //
+  unsigned concurrency() const noexcept
+  {
+    return static_cast<unsigned>(deques.size());
+  }
+
+  // in_pool() true if called from a worker or from within a loop body
+  //
+  static bool in_pool() noexcept { return inside; }
+
+  // for_range(n,grain,f,max_threads) calls f(begin,end) over [0,n) in
+  //  parallel, by at most max_threads threads (0 means concurrency())
+  //
+  template <typename F>
+  void for_range(std::size_t n, std::size_t grain, F&& f,
+                 unsigned max_threads = 0)
+  {
+    if (grain == 0)
+      grain = 1;
+    if (n <= grain || inside || deques.size() == 1 || max_threads == 1)
+    {
+      if (n != 0)
+        f(std::size_t{0}, n);
+      return;
+    }
+
+    std::lock_guard one_loop_at_a_time{submit};
+    {
+      std::lock_guard lock{mutex};
+      job = {[](void* fn, std::size_t b, std::size_t e) {
+               (*static_cast<std::remove_reference_t<F>*>(fn))(b, e);
+             }, &f, grain};
+      remaining.store(n, std::memory_order_relaxed);
+      active = max_threads == 0 || max_threads > deques.size()
+             ? static_cast<unsigned>(deques.size()) : max_threads;
+      error = nullptr;
+      error_set.store(false, std::memory_order_relaxed);
+      for (auto& d : deques)
+        d.reset();
+      deques[0].push({0, n});
+      ++generation;
+      running = true;
+    }
+    wake.notify_all();
+
+    inside = true;
+    run(0);
+    inside = false;
+
+    std::unique_lock lock{mutex};
+    running = false;
+    idle.wait(lock, [this] { return busy == 0; });
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+ private:
+  using range = impl::range_deque::range;
+
+  struct job_t
+  {
+    void (*invoke)(void*, std::size_t, std::size_t);
+    void* fn;
+    std::size_t grain;
+  };
+
+  std::vector<impl::range_deque> deques;
+  std::vector<std::thread> threads;
+
+  std::mutex submit;                // serializes for_range calls
+  std::mutex mutex;                 // guards the fields below
+  std::condition_variable wake;     // workers wait for a loop
+  std::condition_variable idle;     // caller waits for workers to exit
+  std::exception_ptr error;
+  job_t job{};
+  unsigned long generation = 0;
+  unsigned active = 0;              // participating threads, by index
+  unsigned busy = 0;                // workers inside the current loop
+  bool running = false;
+  bool stopping = false;
+
+  std::atomic<std::size_t> remaining{0};   // indices not yet done
+  std::atomic<bool> error_set{false};      // skip the rest on error
+
+  static inline thread_local bool inside = false;
+
+  void work(unsigned self)
+  {
+    inside = true;
+    unsigned long seen = 0;
+    std::unique_lock lock{mutex};
+    for (;;)
+    {
+      wake.wait(lock, [&] {
+        return stopping || (running && generation != seen);
+      });
+      if (stopping)
+        return;
+      seen = generation;
+      if (self >= active)
+        continue;
+      ++busy;
+      lock.unlock();
+      run(self);
+      lock.lock();
+      if (--busy == 0)
+        idle.notify_all();
+    }
+  }
+
+  // run(self) works on own deque, then steals, until the loop is done
+  //
+  void run(unsigned self)
+  {
+    auto& own = deques[self];
+    unsigned victim = self;
+    while (remaining.load(std::memory_order_acquire) != 0)
+    {
+      range r;
+      if (own.pop(r) || steal(victim, self, r))
+        execute(own, r);
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  bool steal(unsigned& victim, unsigned self, range& r)
+  {
+    for (unsigned k = 1; k < active; ++k)
+    {
+      victim = (victim + 1) % active;
+      if (victim != self && deques[victim].steal(r))
+        return true;
+    }
+    return false;
+  }
+
+  // execute(own,r) splits r, pushing upper halves, then runs the rest
+  //
+  void execute(impl::range_deque& own, range r)
+  {
+    while (r.end - r.begin > job.grain)
+    {
+      auto mid = r.begin + (r.end - r.begin) / 2;
+      if (! own.push({mid, r.end}))
+        break;
+      r.end = mid;
+    }
+    if (! error_set.load(std::memory_order_relaxed))
+    {
+      try {
+        job.invoke(job.fn, r.begin, r.end);
+      }
+      catch (...) {
+        std::lock_guard lock{mutex};
+        if (! error)
+          error = std::current_exception();
+        error_set.store(true, std::memory_order_relaxed);
+      }
+    }
+    remaining.fetch_sub(r.end - r.begin, std::memory_order_acq_rel);
+  }
+};
+
+} // par
+
+#include "namespace.hpp"
+
+#endif // LML_THREAD_POOL_HPP
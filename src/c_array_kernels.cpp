@@ -0,0 +1,46 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <wjwray@gmail.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/Lemuriad/c_array_support
+*/
+/*
+  c_array_kernels.cpp
+  ===================
+
+  The c_array_kernels library; the out-of-line kernels of
+  c_array_kernels.hpp, c_array_any.hpp and c_array_half.hpp, and
+  lml::impl::hash_bytes_lib
+  of c_array_hash.hpp, compiled once, for headers used with
+  LML_KERNELS_LIB defined.
+
+  The mismatch kernels are compiled per tier, by target attributes, and
+  dispatched through the kernel table as in the header-only build.
+  The element kernels are multiversioned by target_clones, where the
+  toolchain supports ifunc resolution (GCC or Clang on x86-64 Linux),
+  for baseline x86-64, AVX2 and AVX-512F.
+*/
+
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__)
+#define LML_KERNEL_CLONES \
+        __attribute__((target_clones("default", "avx2", "avx512f")))
+#endif
+
+#define LML_KERNELS_SOURCE
+#include "c_array_kernels.hpp"
+#include "c_array_hash.hpp"
+#include "c_array_any.hpp"
+#include "c_array_half.hpp"
+
+#include "namespace.hpp"
+
+namespace impl {
+
+std::uint64_t hash_bytes_lib(unsigned char const* p, std::size_t n,
+                             std::uint64_t seed) noexcept
+{
+  return hash_bytes(p, n, seed);
+}
+
+} // impl
+
+#include "namespace.hpp"
@@ -0,0 +1,336 @@
+#include "c_array_algorithm.hpp"
+#include "c_array_compare.hpp"
+#include "c_array_hash.hpp"
+// for force_kernel_tier; the algorithms dispatch only if opted in
+#include "c_array_kernels.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+enum class colour : std::uint16_t { red, green, blue };
+
+static_assert( lml::impl::element_kernel<int[4][4]> );
+static_assert( lml::impl::element_kernel<colour(&)[8]> );
+static_assert( lml::impl::element_kernel<double[2]> );
+static_assert( ! lml::impl::element_kernel<int volatile[4]> );
+static_assert( lml::impl::element_kernel<char[2][3]> );
+struct rgb { char r, g, b; };
+static_assert( ! lml::impl::element_kernel<rgb[4]> );
+
+constexpr bool test_constexpr()
+{
+  int a[3][4]{};
+  lml::fill(a, 7);
+  a[2][1] = 9;
+  return lml::find(a, 7) == 0 && lml::find(a, 9) == 9
+      && lml::find(a, 8) == 12 && lml::find(a, 9L) == 9;
+}
+static_assert( test_constexpr() );
+
+// the kernels find the first match, in the blocks and in the tail
+template <typename E>
+bool test_kernels(E x, E y)
+{
+  static E a[100];
+  lml::fill(a, x);
+  for (auto& e : a)
+    assert( e == x );
+  assert( lml::find(a, x) == 0 );
+  assert( lml::find(a, y) == 100 );
+  for (std::size_t i : {0, 1, 15, 16, 17, 63, 99})
+  {
+    a[i] = y;
+    assert( lml::find(a, y) == i );
+    a[i] = x;
+  }
+  return true;
+}
+
+bool test_fill_find()
+{
+  test_kernels<char>('a', 'b');
+  test_kernels<std::int16_t>(-1, 2);
+  test_kernels<colour>(colour::red, colour::blue);
+  test_kernels<int>(7, -7);
+  test_kernels<std::uint64_t>(~0ull, 1ull << 40);
+  static int i;
+  test_kernels<int*>(nullptr, &i);
+
+  // float fills by kernel, finds elementwise, so -0.0 == 0.0
+  double d[20];
+  lml::fill(d, -0.0);
+  assert( lml::find(d, 0.0) == 0 );
+  lml::fill(d, 1);   // converting fill
+  assert( d[19] == 1.0 );
+
+  // not the element type, found elementwise: 300 is never a char
+  char c[64];
+  lml::fill(c, 300 % 256);
+  assert( lml::find(c, 300) == 64 );
+  assert( lml::find(c, 44) == 0 );
+
+  rgb px[8];
+  lml::fill(px, rgb{1, 2, 3});
+  assert( px[7].b == 3 );
+  return true;
+}
+
+// hash is the same with or without the library
+bool test_hash()
+{
+  unsigned char bytes[200]{};
+  static constexpr unsigned char zeros[200]{};
+  constexpr auto h = lml::hash{}(zeros);
+  assert( lml::hash{}(bytes) == h );
+  return true;
+}
+
+// extents are checked by the type system
+template <typename D, typename S, typename I>
+concept gatherable = requires (D& d, S const& s, I const& i) {
+                       lml::gather(d, s, i); };
+static_assert( gatherable<int[2][3], int[100], int[2][3]>
+            && gatherable<double[6], float[3][4], unsigned char[6]> );
+static_assert( ! gatherable<int[2][3], int[6], int[6]>
+            && ! gatherable<int[6], int[6], float[6]> );
+
+constexpr bool test_permute_constexpr()
+{
+  int a[2][3] {{10,11,12},{13,14,15}}, g[2][3];
+  int p[2][3] {{5,3,4},{0,2,1}};
+  lml::gather(g, a, p);
+  lml::permute_inplace(a, p);
+  bool ok = lml::equal_to{}(a, g) && a[0][0] == 15 && p[0][0] == 5;
+  constexpr unsigned char q[2][3] {{1,2,0},{4,3,5}};
+  lml::permute_inplace(a, q);
+  int s[6] {};
+  lml::scatter(s, q, q);
+  return ok && a[0][0] == 13 && a[1][0] == 12 && s[4] == 4 && s[5] == 5;
+}
+static_assert( test_permute_constexpr() );
+
+// gather by kernel at each tier, blocks and tail, agrees with the loop
+template <typename E, typename I>
+bool test_gather(std::size_t n)
+{
+  static E s[1000], d[1000], r[1000];
+  static I idx[1000];
+  for (std::size_t i = 0; i != 1000; ++i) {
+    s[i] = static_cast<E>(i * 3 + 1);
+    idx[i] = static_cast<I>((i * 7919) % n);
+  }
+  for (auto t : {lml::kernel_tier::scalar, lml::kernel_tier::avx2,
+                 lml::kernel_tier::avx512})
+  {
+    if (! lml::force_kernel_tier(t))
+      continue;
+    lml::fill(d, E{});
+    lml::gather(d, s, idx);
+    for (std::size_t i = 0; i != 1000; ++i)
+      assert( d[i] == s[idx[i]] );
+  }
+  lml::force_kernel_tier(lml::impl::best_table()->tier);
+  lml::scatter(r, d, idx);
+  for (std::size_t i = 0; i != 1000; ++i)
+    assert( r[idx[i]] == d[i] );
+  return true;
+}
+
+// a source over gather_prefetch_bytes, prefetched
+bool test_gather_prefetch()
+{
+  static float s[1 << 19], d[4096];
+  static int idx[4096];
+  static_assert( sizeof s > lml::gather_prefetch_bytes );
+  for (int i = 0; i != 1 << 19; ++i)
+    s[i] = float(i);
+  for (int i = 0; i != 4096; ++i)
+    idx[i] = (i * 40503) & ((1 << 19) - 1);
+  lml::gather(d, s, idx);
+  for (int i = 0; i != 4096; ++i)
+    assert( d[i] == float(idx[i]) );
+  return true;
+}
+
+// permute by a random-ish permutation, mutable and const
+bool test_permute()
+{
+  static int p[4096], a[4096], b[4096], g[4096];
+  for (int i = 0; i != 4096; ++i)
+    p[i] = i;
+  for (int i = 4095; i > 0; --i) {
+    int j = (i * 2654435761u) % (i + 1);
+    std::swap(p[i], p[j]);
+  }
+  for (int i = 0; i != 4096; ++i)
+    a[i] = b[i] = i * 5;
+  lml::gather(g, a, p);
+  lml::permute_inplace(a, p);
+  assert( lml::equal_to{}(a, g) && p[0] >= 0 );
+  lml::permute_inplace(b, std::as_const(p));
+  assert( lml::equal_to{}(b, g) );
+
+  unsigned short u[4][4];
+  std::string str[4][4], sg[4][4];
+  for (int i = 0; i != 16; ++i) {
+    u[i/4][i%4] = static_cast<unsigned short>((i + 5) % 16);
+    str[i/4][i%4] = std::string(20, char('a' + i));
+  }
+  lml::gather(sg, str, u);
+  lml::permute_inplace(str, u);
+  assert( lml::equal_to{}(str, sg) && u[0][0] == 5 );
+  return true;
+}
+
+// reverse, rotate and shift along each axis, in constant evaluation
+constexpr bool test_axis_constexpr()
+{
+  int a[2][3] {{1,2,3},{4,5,6}};
+  lml::reverse<1>(a);
+  bool ok = a[0][0] == 3 && a[0][2] == 1 && a[1][0] == 6;
+  lml::reverse(a);
+  ok = ok && a[0][0] == 6 && a[1][2] == 1;
+  int r[5] {0,1,2,3,4};
+  lml::rotate(r, 2);
+  ok = ok && r[0] == 2 && r[3] == 0 && r[4] == 1;
+  lml::rotate(r, -2);
+  ok = ok && r[0] == 0 && r[4] == 4;
+  lml::rotate(r, 12);
+  ok = ok && r[0] == 2;
+  int s[2][2][3] {{{1,2,3},{4,5,6}},{{7,8,9},{10,11,12}}};
+  lml::shift<1>(s, 1, 0);
+  ok = ok && s[0][0][2] == 0 && s[0][1][0] == 1 && s[1][1][2] == 9;
+  lml::shift<2>(s, -1, -1);
+  ok = ok && s[0][1][0] == 2 && s[0][1][2] == -1 && s[1][1][1] == 9;
+  lml::shift<0>(s, 5, 7);
+  return ok && s[0][0][0] == 7 && s[1][1][2] == 7;
+}
+static_assert( test_axis_constexpr() );
+
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+using int2x0 = int[2][0];
+using int0x2 = int[0][2];
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+
+// zero extents, before, at or after the axis, are no-ops
+constexpr bool test_axis_zero()
+{
+  int2x0 a {};
+  int0x2 b {};
+  lml::reverse<1>(a); lml::rotate<1>(a, 3); lml::shift<1>(a, 1, 0);
+  lml::reverse<1>(b); lml::rotate<0>(b, 3); lml::shift<0>(b, -1, 0);
+  return true;
+}
+static_assert( test_axis_zero() );
+
+template <typename A, std::size_t X>
+concept axis_op = requires (A& a) { lml::reverse<X>(a); };
+static_assert( axis_op<int[2][3], 1> && ! axis_op<int[2][3], 2>
+            && ! axis_op<int const[2], 0> );
+
+// at runtime, against index arithmetic, for bulk and elementwise paths
+template <typename T>
+bool test_axis()
+{
+  static T a[6][5][40];
+  auto num = [](int n) {
+    if constexpr (std::is_same_v<T, std::string>)
+      return std::to_string(n);
+    else
+      return T(n);
+  };
+  auto val = [&](int i, int j, int k) { return num(i * 1000 + j * 100 + k); };
+  auto reset = [&] {
+    for (int i = 0; i != 6; ++i)
+      for (int j = 0; j != 5; ++j)
+        for (int k = 0; k != 40; ++k)
+          a[i][j][k] = val(i, j, k);
+  };
+  auto check = [&](auto f) {
+    for (int i = 0; i != 6; ++i)
+      for (int j = 0; j != 5; ++j)
+        for (int k = 0; k != 40; ++k)
+          assert( a[i][j][k] == f(i, j, k) );
+  };
+  reset();
+  lml::reverse<0>(a);
+  check([&](int i, int j, int k) { return val(5 - i, j, k); });
+  reset();
+  lml::reverse<2>(a);
+  check([&](int i, int j, int k) { return val(i, j, 39 - k); });
+  for (int k : {0, 1, -1, 3, 7, -13, 40, 81}) {
+    reset();
+    lml::rotate<1>(a, k);
+    check([&](int i, int j, int l) {
+      return val(i, ((j + k) % 5 + 5) % 5, l); });
+    reset();
+    lml::rotate<2>(a, k);
+    check([&](int i, int j, int l) {
+      return val(i, j, ((l + k) % 40 + 40) % 40); });
+  }
+  for (int k : {0, 1, -1, 2, -4, 5, -6, 9}) {
+    reset();
+    lml::shift<0>(a, k, num(-1));
+    check([&](int i, int j, int l) {
+      return i - k >= 0 && i - k < 6 ? val(i - k, j, l) : num(-1); });
+    reset();
+    lml::shift<2>(a, k * 5, num(-1));
+    check([&](int i, int j, int l) {
+      return l - k*5 >= 0 && l - k*5 < 40 ? val(i, j, l - k*5) : num(-1); });
+  }
+  return true;
+}
+
+// reverse and rotate of rows by kernel at each tier, blocks and middle
+template <typename E, std::size_t N>
+bool test_reverse_kernel()
+{
+  static E a[3][N];
+  auto reset = [] {
+    for (std::size_t i = 0; i != 3; ++i)
+      for (std::size_t j = 0; j != N; ++j)
+        a[i][j] = static_cast<E>(i * 1000 + j + 1);
+  };
+  for (auto t : {lml::kernel_tier::scalar, lml::kernel_tier::avx2,
+                 lml::kernel_tier::avx512})
+  {
+    if (! lml::force_kernel_tier(t))
+      continue;
+    reset();
+    lml::reverse<1>(a);
+    for (std::size_t i = 0; i != 3; ++i)
+      for (std::size_t j = 0; j != N; ++j)
+        assert( a[i][j] == static_cast<E>(i * 1000 + N - j) );
+    reset();
+    lml::rotate<1>(a, 5);
+    for (std::size_t i = 0; i != 3; ++i)
+      for (std::size_t j = 0; j != N; ++j)
+        assert( a[i][j] == static_cast<E>(i * 1000 + (j + 5) % N + 1) );
+  }
+  lml::force_kernel_tier(lml::impl::best_table()->tier);
+  return true;
+}
+
+int main()
+{
+  test_fill_find();
+  test_hash();
+  test_gather<int, int>(1000);
+  test_gather<float, unsigned>(7);
+  test_gather<double, int>(999);
+  test_gather<std::uint64_t, int>(13);
+  test_gather<short, long>(1000);
+  test_gather_prefetch();
+  test_permute();
+  test_axis<int>();
+  test_axis<double>();
+  test_axis<std::string>();
+  test_reverse_kernel<unsigned char, 640>();
+  test_reverse_kernel<unsigned char, 83>();
+  test_reverse_kernel<std::int16_t, 47>();
+  test_reverse_kernel<float, 200>();
+  test_reverse_kernel<std::uint64_t, 9>();
+  test_reverse_kernel<double, 33>();
+}
@@ -0,0 +1,131 @@
+#include "c_array_aligned.hpp"
+#include "c_array_simd.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+using lml::aligned_array;
+
+static_assert( alignof(aligned_array<float,64,1024>) == 64 );
+static_assert( sizeof(aligned_array<float,64,1024>) == 4096 );
+static_assert( sizeof(aligned_array<char,32,3>) == 32 );
+static_assert( std::is_aggregate_v<aligned_array<int,16,2,2>> );
+static_assert( std::is_same_v<aligned_array<int,16,2,3>::array_type,
+                              int[2][3]> );
+
+static_assert( lml::array_alignment_v<double[4]> == alignof(double) );
+static_assert( lml::array_alignment_v<aligned_array<int,32,8> const&>
+                                                                  == 32 );
+static_assert( lml::c_array_aligned<aligned_array<int,32,8>, 32> );
+static_assert( lml::c_array_aligned<aligned_array<int,32,8>&, 16> );
+static_assert( ! lml::c_array_aligned<aligned_array<int,32,8>, 64> );
+static_assert( lml::c_array_aligned<int[8], alignof(int)> );
+static_assert( ! lml::c_array_aligned<int[8], 32> );
+static_assert( ! lml::c_array_aligned<int, 4> );
+
+template <typename T, std::size_t A, int... I>
+concept valid_aligned_array = requires { sizeof(aligned_array<T,A,I...>); };
+static_assert( ! valid_aligned_array<int,32> );    // no extents
+static_assert( ! valid_aligned_array<int,24,4> );  // not a power of two
+static_assert( ! valid_aligned_array<double,4,4> ); // under-aligned
+
+// comparisons are constexpr, by lml::equal_to and compare_three_way
+constexpr aligned_array<int,16,3> x{{1, 2, 3}}, y{{1, 2, 4}};
+static_assert( x == x && x != y && x < y && y > x );
+static_assert( (x <=> y) < 0 );
+
+// ci a case-insensitive char, with its own == and <=>
+struct ci
+{
+  char c;
+  static constexpr char fold(char c) { return c | ('a' ^ 'A'); }
+  friend constexpr bool operator==(ci l, ci r) {
+    return fold(l.c) == fold(r.c); }
+  friend constexpr std::weak_ordering operator<=>(ci l, ci r) {
+    return fold(l.c) <=> fold(r.c); }
+};
+
+bool test_aligned_array()
+{
+  aligned_array<float,64,1024> a{}, b{};
+  assert( reinterpret_cast<std::uintptr_t>(&a) % 64 == 0 );
+  a[3] = 1.f;
+  b = a;
+  assert( a == b );
+  b[1000] = 2.f;
+  assert( a != b && a < b );
+
+  float (&f)[1024] = a;
+  assert( &f == &a.data );
+
+  aligned_array<std::uint32_t,64,8,16> m{};
+  m[7][15] = 1;
+  auto n = m;
+  assert( n == m );
+  n[0][0] = 1;
+  assert( m < n );
+
+  aligned_array<ci,64,70> u, v;  // class elements, elementwise
+  for (int i = 0; i != 70; ++i)
+    u[i] = {'k'}, v[i] = {'K'};
+  assert( u == v && (u <=> v) == 0 );
+  v[69] = {'L'};
+  assert( u != v && u < v );
+  return true;
+}
+
+bool test_assume_aligned_flat()
+{
+  aligned_array<float,64,4,256> a{};
+  float (&f)[1024] = lml::assume_aligned_flat(a);
+  for (auto& e : f)
+    e = 2;
+  assert( a[3][255] == 2 );
+
+  alignas(32) int raw[4][8]{};
+  auto& r = lml::assume_aligned_flat<32>(raw);
+  static_assert( std::is_same_v<decltype(r), int(&)[32]> );
+  r[31] = 5;
+  assert( raw[3][7] == 5 );
+
+  int const (&cr)[32] = lml::assume_aligned_flat(std::as_const(raw));
+  assert( cr[31] == 5 );
+  return true;
+}
+
+#if defined(LML_SIMD_STDX) || defined(LML_SIMD_VECTOR_EXT)
+// simd loads and stores of aligned_arrays
+bool test_simd()
+{
+  aligned_array<int,32,2,4> m{{{1, 2, 3, 4}, {5, 6, 7, 8}}};
+  lml::simd_store(m, lml::simd_load(m) + 1);
+  assert( m[0][0] == 2 && m[1][3] == 9 );
+
+  aligned_array<float,64,100> a{};
+  for (auto c : lml::simd_view(a))
+    c.store(c.load() + 1);
+  for (int i = 0; i != 100; ++i)
+    assert( a[i] == 1 );
+
+  auto const& ca = a;
+  float sum = 0;
+  for (auto c : lml::simd_view(ca))
+  {
+    auto v = c.load();
+    for (std::size_t i = 0; i != c.size(); ++i)
+      sum += v[i];
+  }
+  assert( sum == 100 );
+  return true;
+}
+#endif
+
+int main()
+{
+  test_aligned_array();
+  test_assume_aligned_flat();
+#if defined(LML_SIMD_STDX) || defined(LML_SIMD_VECTOR_EXT)
+  test_simd();
+#endif
+}
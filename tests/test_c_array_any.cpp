@@ -0,0 +1,116 @@
+#include "c_array_any.hpp"
+#include "c_array_algorithm.hpp"
+#include "c_array_compare.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+enum class colour : std::uint16_t { red, green, blue };
+enum sign : signed char { minus = -1, zero, plus };
+
+static_assert( lml::any_element<int> && lml::any_element<bool>
+            && lml::any_element<colour> && lml::any_element<char const*>
+            && lml::any_element<double> && lml::any_element<int const> );
+static_assert( ! lml::any_element<long double>
+            && ! lml::any_element<std::nullptr_t>
+            && ! lml::any_element<int volatile>
+            && ! lml::any_element<int[2]> );
+struct rgb { char r, g, b; };
+static_assert( ! lml::any_element<rgb> );
+
+static_assert( lml::element_type_of<colour>
+            == lml::element_type{lml::element_kind::unsigned_int, 2} );
+static_assert( lml::element_type_of<sign>.kind
+            == lml::element_kind::signed_int );
+static_assert( lml::element_type_of<float const>
+            == lml::element_type{lml::element_kind::floating, 4} );
+static_assert( lml::element_type_of<int*>.kind
+            == lml::element_kind::pointer );
+
+static_assert( std::is_convertible_v<int(&)[2][3], lml::any_array_ref> );
+static_assert( std::is_convertible_v<int const(&)[2][3],
+                                     lml::any_array_cref> );
+static_assert( ! std::is_convertible_v<int const(&)[2][3],
+                                       lml::any_array_ref> );
+static_assert( ! std::is_convertible_v<rgb(&)[2], lml::any_array_cref> );
+static_assert( std::is_convertible_v<lml::any_array_ref,
+                                     lml::any_array_cref> );
+
+constexpr int c23[2][3] {{1,2,3},{4,5,6}};
+static_assert( lml::any_array_cref{c23}.rank() == 2
+            && lml::any_array_cref{c23}.extent(0) == 2
+            && lml::any_array_cref{c23}.extent(1) == 3
+            && lml::any_array_cref{c23}.size() == 6
+            && lml::any_array_cref{c23}.size_bytes() == 6 * sizeof(int) );
+
+bool test_shape()
+{
+  int a[2][3]{}, b[6]{}, c[3][2]{};
+  unsigned u[2][3]{};
+  assert( lml::same_shape(a, a) );
+  assert( ! lml::same_shape(a, b) && ! lml::same_shape(a, c) );
+  assert( ! lml::same_shape(a, u) );
+  assert( ! lml::any_copy(a, b) && ! lml::any_equal(a, b) );
+  assert( lml::any_compare(a, u) == std::partial_ordering::unordered );
+  lml::any_array_ref r = a;
+  assert( r.data() == &a );
+  return true;
+}
+
+// each kind matches the typed lml functors
+template <typename E, int N>
+bool test_kind(E x, E y)
+{
+  E a[N][3], b[N][3];
+  lml::any_fill(a, &x);
+  lml::fill(b, x);
+  assert( lml::equal_to{}(a, b) && lml::any_equal(a, b) );
+  assert( lml::any_hash(a) == lml::hash{}(a) );
+  assert( lml::any_compare(a, b) == 0 );
+  b[N-1][2] = y;
+  assert( ! lml::any_equal(a, b) );
+  assert( lml::any_compare(a, b) == lml::compare_three_way{}(a, b) );
+  assert( lml::any_compare(b, a) == lml::compare_three_way{}(b, a) );
+  assert( lml::any_hash(b) == lml::hash{}(b) );
+  assert( lml::any_copy(a, b) && lml::equal_to{}(a, b) );
+  return true;
+}
+
+bool test_kinds()
+{
+  test_kind<char, 2>('a', 'b');
+  test_kind<signed char, 30>(-1, 1);
+  test_kind<bool, 4>(true, false);
+  test_kind<sign, 2>(minus, plus);
+  test_kind<short, 20>(-300, 300);
+  test_kind<colour, 2>(colour::blue, colour::red);
+  test_kind<int, 2>(-1, 256);
+  test_kind<unsigned, 10>(0x100, 1);
+  test_kind<std::int64_t, 3>(-1, 1);
+  test_kind<std::uint64_t, 3>(1ull << 40, 1);
+  test_kind<float, 2>(1.5f, -2.f);
+  test_kind<double, 10>(0.25, 0.5);
+  static int i[2];
+  test_kind<int*, 2>(i, i + 1);
+  return true;
+}
+
+// floats compare as values: -0 == +0, NaN unordered
+bool test_floats()
+{
+  double a[4] {0.0, 1, 2, 3}, b[4] {-0.0, 1, 2, 3};
+  assert( lml::any_equal(a, b) );
+  assert( lml::any_hash(a) == lml::any_hash(b) );
+  b[2] = std::nan("");
+  assert( ! lml::any_equal(a, b) );
+  assert( lml::any_compare(a, b) == std::partial_ordering::unordered );
+  return true;
+}
+
+int main()
+{
+  test_shape();
+  test_kinds();
+  test_floats();
+}
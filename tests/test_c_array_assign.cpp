@@ -1,6 +1,18 @@
 #include "test_c_array_assign.hpp"
 
+#include <array>
 #include <cassert>
+#include <list>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// the core headers leave the dispatch machinery out unless opted in
+#if defined(LML_C_ARRAY_KERNELS_HPP) || defined(LML_C_ARRAY_BOUNDED_HPP)
+#error "c_array_assign.hpp includes c_array_kernels or c_array_bounded"
+#endif
+static_assert( ! lml::impl::kernels_dispatched );
 
 bool test_assign_to_array1D()
 {
@@ -67,10 +79,28 @@ bool test_assign_array2D()
   assert( b[0][0] == 0 && b[1][0] == 0 );
   lml::assign(b[0]) = a[2];
   assert( b[0][0] == 5 && b[0][1] == 6 );
+  lml::assign(b) = b;
+  assert( b[0][0] == 5 && b[0][1] == 6 && b[2][1] == 0 );
 
   return true;
 }
 
+// Runtime copies of bulk_copyable arrays are a single memmove
+static_assert( lml::bulk_copyable<int[3][2], int const(&)[3][2]> );
+static_assert( lml::bulk_copyable<int(&)[6], int[6]> );
+static_assert( ! lml::bulk_copyable<int[3][2], int[6]> );
+static_assert( ! lml::bulk_copyable<int[2], long[2]> );
+static_assert( ! lml::bulk_copyable<int[2], int volatile[2]> );
+static_assert( ! lml::bulk_copyable<int*[2], int[2]> );
+
+constexpr bool test_assign_constexpr()
+{
+  int a[3][2]{{1,2},{3,4},{5,6}}, b[3][2]{};
+  lml::assign(b) = a;
+  return b[2][1] == 6;
+}
+static_assert( test_assign_constexpr() );
+
 bool test_assign_elements()
 {
   int a[3][2], b[3][2];
@@ -95,6 +125,55 @@ bool test_assign_elements()
   return true;
 }
 
+constexpr bool test_assign_range_constexpr()
+{
+  int a[2][3] {};
+  std::array<std::array<int,3>,2> s {{{1,2,3},{4,5,6}}};
+  lml::assign(a) = s;
+  return a[0][0] == 1 && a[1][2] == 6;
+}
+static_assert( test_assign_range_constexpr() );
+
+static_assert( lml::impl::bulk_range<int, std::vector<int>&>() );
+static_assert( lml::impl::bulk_range<int, std::array<std::array<int,3>,2>>() );
+static_assert( ! lml::impl::bulk_range<int, std::vector<short>&>() );
+static_assert( ! lml::impl::bulk_range<int, std::list<int>&>() );
+static_assert( lml::impl::static_flat_size<int, std::span<int,4>>() == 4 );
+static_assert( lml::impl::static_flat_size<int, std::vector<int[2]>&>()
+            == lml::impl::dynamic_size );
+
+bool test_assign_range()
+{
+  float f[2][3];
+  std::vector<float> v {1,2,3,4,5,6};
+  lml::assign(f) = v;                       // memcpy
+  assert( f[0][0] == 1 && f[1][2] == 6 );
+  lml::assign(f[1]) = std::span<float,3>(v.data(), 3);
+  assert( f[1][0] == 1 && f[1][2] == 3 );
+
+  std::list<double> d {.5, 1.5, 2.5};       // streamed, converted
+  lml::assign(f[0]) = d;
+  assert( f[0][0] == .5f && f[0][2] == 2.5f );
+
+  std::vector<std::vector<int>> vv {{1,2,3},{4,5,6}};
+  int a[2][3] {};
+  lml::assign(a) = vv;                      // nested, dynamic
+  assert( a[1][0] == 4 );
+  lml::assign(a) = std::vector<std::array<int,3>>{{9,8,7},{6,5,4}};
+  assert( a[0][0] == 9 && a[1][2] == 4 );
+
+  std::string s[2];
+  std::vector<char const*> cs {"one", "two"};
+  lml::assign(s) = cs;
+  assert( s[1] == "two" );
+
+  v.pop_back();
+  bool threw = false;
+  try { lml::assign(f) = v; } catch (std::length_error const&) { threw = true; }
+  assert( threw && f[0][0] == .5f );
+  return true;
+}
+
 int main()
 {
   test_assign_to_array1D();
@@ -103,6 +182,7 @@ int main()
   test_assign_array1D();
   test_assign_array2D();
   test_assign_elements();
+  test_assign_range();
 
   wrap<int> wi{2};
   auto& [wiv] = wi;
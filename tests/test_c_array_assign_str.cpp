@@ -0,0 +1,75 @@
+#include "c_array_assign_str.hpp"
+
+#include <cassert>
+#include <string>
+
+using enum lml::str_policy;
+
+constexpr bool test_constexpr()
+{
+  char a[4] {'x','x','x','x'}, b[4] {};
+  lml::assign_str(a) = "ab";
+  lml::assign_str<space_pad | nul_term>(b) = "abcdef";
+  return a[1] == 'b' && a[2] == 0 && a[3] == 0
+      && b[2] == 'c' && b[3] == 0;
+}
+static_assert( test_constexpr() );
+
+// every length, to the capacity and past, for small and large buffers
+template <lml::str_policy P, std::size_t N>
+bool test_lengths()
+{
+  constexpr std::size_t cap = decltype(lml::assign_str<P>(
+                                std::declval<char(&)[N]>()))::capacity;
+  constexpr char pad = P & space_pad ? ' ' : '\0';
+  std::string s(N + 2, '-');
+  for (std::size_t n = 0; n != s.size(); ++n) {
+    for (std::size_t i = 0; i != n; ++i)
+      s[i] = char('a' + i % 26);
+    char buf[N + 2];
+    std::memset(buf, '#', sizeof buf);
+    char (&b)[N] = reinterpret_cast<char(&)[N]>(buf);
+    bool threw = false;
+    try { lml::assign_str<P>(b) = std::string_view(s).substr(0, n); }
+    catch (std::length_error const&) { threw = true; }
+    assert( threw == (P & strict && n > cap) );
+    if (threw) {
+      assert( buf[0] == '#' );
+      continue;
+    }
+    for (std::size_t i = 0; i != N; ++i)
+      assert( b[i] == (i < n && i < cap ? s[i]
+                     : i == N - 1 && P & nul_term ? '\0' : pad) );
+    assert( buf[N] == '#' && buf[N + 1] == '#' );
+  }
+  return true;
+}
+
+int main()
+{
+  test_lengths<nul_pad, 1>();
+  test_lengths<nul_pad, 8>();
+  test_lengths<space_pad, 13>();
+  test_lengths<nul_term, 32>();
+  test_lengths<nul_term | strict, 17>();
+  test_lengths<space_pad | strict, 33>();
+  test_lengths<space_pad | nul_term, 100>();
+
+  char8_t u[6];
+  lml::assign_str(u) = u8"hé";
+  assert( u[1] == 0xC3 && u[2] == 0xA9 && u[3] == 0 );
+
+  struct wire { char sym[8]; char acct[12]; } w;
+  std::string acct = "ACCT-0001";
+  lml::assign_str<space_pad>(w.acct) = acct;
+  lml::assign_str(w.sym) = "EURUSD";
+  assert( w.acct[9] == ' ' && w.sym[5] == 'D' && w.sym[6] == 0 );
+
+  // the source may be a view of the buffer itself
+  char buf[8] = "abcdefg";
+  lml::assign_str(buf) = std::string_view(buf + 1, 3);
+  assert( std::string_view(buf) == "bcd" );
+  char big[40] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  lml::assign_str(big) = std::string_view(big + 2, 34);
+  assert( std::string_view(big) == "23456789abcdefghijklmnopqrstuvwxyz" );
+}
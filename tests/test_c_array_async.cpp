@@ -0,0 +1,153 @@
+#include "c_array_async.hpp"
+
+#include <cassert>
+#include <deque>
+#include <string>
+
+// scheduler, a stand-in for an event loop executor
+struct scheduler
+{
+  std::deque<std::coroutine_handle<>> queue;
+  int posts = 0;
+
+  void post(std::coroutine_handle<> h) { queue.push_back(h); ++posts; }
+
+  // run() resumes posted handles until none remain, counting them
+  int run()
+  {
+    int n = 0;
+    for (; ! queue.empty(); ++n)
+    {
+      auto h = queue.front();
+      queue.pop_front();
+      h.resume();
+    }
+    return n;
+  }
+};
+
+static_assert( lml::executor<scheduler> );
+
+// detached, a fire-and-forget coroutine for the test
+struct detached
+{
+  struct promise_type
+  {
+    detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() { throw; }
+  };
+};
+
+static int big[64][1024];
+static int other[64][1024];
+
+bool test_async_assign()
+{
+  for (int i = 0; i != 64 * 1024; ++i)
+    lml::flat_index(other, i) = i;
+
+  // 256KiB in 64KiB chunks, by hand
+  auto copy = lml::async_assign(big, other, 1 << 16);
+  assert( ! copy.done() && big[0][1] == 0 );   // lazy
+  int resumes = 1;
+  while (copy.resume())
+  {
+    assert( big[16 * resumes - 1][1023] == other[16 * resumes - 1][1023] );
+    assert( big[16 * resumes][0] == 0 );
+    ++resumes;
+  }
+  assert( resumes == 4 && copy.done() );
+  assert( lml::equal_to{}(big, other) );
+
+  // non bulk copyable elements
+  std::string s[3]{"a","b","c"}, t[3];
+  auto str = lml::async_assign(t, s, 1);
+  int n = 0;
+  while (str.resume())
+    ++n;
+  assert( n == 2 && t[2] == "c" );
+
+  return true;
+}
+
+// ci a case-insensitive char, with its own ==
+struct ci
+{
+  char c;
+  friend constexpr bool operator==(ci l, ci r) {
+    return (l.c | 0x20) == (r.c | 0x20); }
+};
+
+bool test_async_equal_to()
+{
+  auto eq = lml::async_equal_to(big, other, 1 << 16);
+  while (eq.resume());
+  assert( eq.result() );
+
+  // early exit in the first chunk
+  big[1][2] = -1;
+  auto ne = lml::async_equal_to(big, other, 1 << 16);
+  assert( ! ne.resume() && ! ne.result() );
+  big[1][2] = other[1][2];
+
+  float f[2]{0.f, -0.f}, g[2]{-0.f, 0.f};
+  auto feq = lml::async_equal_to(f, g);
+  feq.resume();
+  assert( feq.result() );  // elementwise == for float, not memcmp
+
+  ci u[70], v[70];
+  for (int i = 0; i != 70; ++i)
+    u[i] = {'x'}, v[i] = {'X'};
+  auto ceq = lml::async_equal_to(u, v);
+  while (ceq.resume());
+  assert( ceq.result() );  // elementwise == for class elements, not memcmp
+
+  return true;
+}
+
+// awaited via an executor; the chunks interleave with other posted work
+bool test_async_via()
+{
+  scheduler loop;
+  bool copied = false, equal = false;
+  int ticks = 0;
+
+  // the lambdas outlive their coroutines, which refer to the captures
+  auto copier = [&]() -> detached {
+    co_await lml::async_assign(big, other, 1 << 16).via(loop);
+    copied = true;
+    equal = co_await lml::async_equal_to(big, other, 1 << 16).via(loop);
+  };
+  auto ticker = [&]() -> detached {
+    for (int i = 0; i != 3; ++i)
+    {
+      struct yield {
+        scheduler& s;
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> h) { s.post(h); }
+        void await_resume() {}
+      };
+      co_await yield{loop};
+      ++ticks;
+      assert( ! equal );
+    }
+  };
+  copier();
+  ticker();
+
+  int resumes = loop.run();
+  assert( copied && equal && ticks == 3 );
+  assert( resumes == 4 + 4 + 3 );
+
+  return true;
+}
+
+int main()
+{
+  test_async_assign();
+  test_async_equal_to();
+  test_async_via();
+}
@@ -0,0 +1,66 @@
+#include "c_array_bit_cast.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+static_assert( std::is_same_v<lml::array_of_t<int[2][3]>,
+                              lml::array<int,2,3>> );
+static_assert( std::is_same_v<lml::array_of_t<char const(&)[4]>,
+                              lml::array<char,4>> );
+static_assert( sizeof(lml::array<std::uint8_t,3>) == 3 );
+
+static_assert( lml::bit_castable<std::uint32_t[4], std::uint8_t[16]> );
+static_assert( ! lml::bit_castable<std::uint32_t[4], std::uint8_t[15]> );
+static_assert( ! lml::bit_castable<std::uint8_t[8], std::uint8_t*> ||
+               sizeof(void*) == 8 );
+
+struct v128 { std::uint64_t lo, hi; };
+
+constexpr std::uint8_t bytes[16]{1,0,0,0, 2,0,0,0, 3,0,0,0, 4,0,0,0};
+
+// array to array, constexpr, with the result a wrapped array
+constexpr auto words = lml::bit_cast<std::uint32_t[4]>(bytes);
+static_assert( std::is_same_v<decltype(words),
+                              lml::array<std::uint32_t,4> const> );
+static_assert( words[0] == 1 && words[3] == 4 );
+
+// array to struct, struct to multidimensional array
+constexpr v128 v = lml::bit_cast<v128>(bytes);
+static_assert( v.lo == 0x0000000200000001 && v.hi == 0x0000000400000003 );
+
+constexpr auto m = lml::bit_cast<std::uint16_t[2][4]>(v);
+static_assert( m[0][0] == 1 && m[0][2] == 2 && m[1][0] == 3 );
+
+// round trip
+static_assert( lml::bit_cast<std::uint8_t[16]>(words) ==
+               lml::bit_cast<std::uint8_t[16]>(v) );
+
+// out-parameter forms
+constexpr bool test_into()
+{
+  std::uint16_t halves[8]{};
+  lml::bit_cast(halves, v);
+  v128 w{};
+  lml::bit_cast(w, halves);
+  return halves[6] == 4 && w.lo == v.lo && w.hi == v.hi;
+}
+static_assert( test_into() );
+
+template <typename To, typename From>
+concept out_castable = requires (To& t, From const& f) { lml::bit_cast(t, f); };
+static_assert( ! out_castable<std::uint32_t const[4], std::uint8_t[16]> );
+static_assert( out_castable<std::uint32_t[2][2], std::uint8_t[16]> );
+
+int main()
+{
+  float f[2] {1.0f, -2.0f};
+  auto u = lml::bit_cast<std::uint32_t[2]>(f);
+  assert( u[0] == 0x3f800000 && u[1] == 0xc0000000 );
+
+  double d;
+  lml::bit_cast(d, u);
+  assert( lml::bit_cast<std::uint64_t>(d) == 0xc00000003f800000 );
+
+  std::uint32_t (&ua)[2] = u;
+  assert( &ua == &u.data );
+}
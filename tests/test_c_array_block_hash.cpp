@@ -0,0 +1,78 @@
+#include "c_array_block_hash.hpp"
+
+#include <cassert>
+
+using block_hashed = lml::block_hashed<int[3][1000], 256>;
+
+static_assert( block_hashed::block_size == 64 );
+static_assert( block_hashed::block_count == 47 );
+static_assert( block_hashed::leaf_base == 64 );
+
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+using int0 = int[0];
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+static_assert( lml::block_hashed<int0>::block_count == 0 );
+
+bool test_block_hashed()
+{
+  static int a[3][1000], b[3][1000];
+  for (int i = 0; i != 3000; ++i)
+    lml::flat_index(a, i) = lml::flat_index(b, i) = i;
+
+  block_hashed ha{a}, hb{b};
+  assert( ha.root_hash() == hb.root_hash() );
+  assert( ha.dirty_count() == 0 );
+
+  ha.set(70, -1);
+  ha.write(2999) = -1;
+  assert( ha.dirty_count() == 2 && ha.is_dirty(1) && ha.is_dirty(46) );
+  assert( ha[70] == -1 && a[2][999] == -1 );
+
+  ha.rehash();
+  assert( ha.dirty_count() == 0 );
+  assert( ha.root_hash() != hb.root_hash() );
+
+  int divergent[4], n = 0;
+  ha.for_each_divergent_block(hb, [&](std::size_t b) { divergent[n++] = b; });
+  assert( n == 2 && divergent[0] == 1 && divergent[1] == 46 );
+
+  // the incremental root hash matches a from-scratch rehash
+  block_hashed hc{a};
+  assert( hc.root_hash() == ha.root_hash() );
+
+  // bulk assign then untracked write plus explicit mark
+  ha.assign(b);
+  assert( ha.rehash() == hb.root_hash() );
+  ha.writable()[1][5] = 7;
+  ha.mark_dirty(1005, 1);
+  hb.assign({});
+  ha.rehash();
+  hb.rehash();
+  n = 0;
+  ha.for_each_divergent_block(hb, [&](std::size_t) { ++n; });
+  assert( n == 47 );
+
+  return true;
+}
+
+// Large enough to exercise the parallel rehash
+bool test_block_hashed_parallel()
+{
+  static unsigned a[1 << 22];
+  lml::block_hashed ha{a};
+  auto root = ha.root_hash();
+
+  for (unsigned i = 0; i < 1 << 22; i += 1000)
+    ha.set(i, i);
+  ha.rehash();
+  assert( ha.root_hash() != root );
+  assert( ha.root_hash() == lml::block_hashed{a}.root_hash() );
+
+  return true;
+}
+
+int main()
+{
+  test_block_hashed();
+  test_block_hashed_parallel();
+}
@@ -0,0 +1,139 @@
+#include "c_array_bounded.hpp"
+#include "c_array_algorithm.hpp"
+#include "c_array_assign.hpp"
+#include "c_array_compare.hpp"
+#include "c_array_hash.hpp"
+
+#include <cassert>
+
+// the algorithms leave the dispatch machinery out unless opted in
+#if defined(LML_C_ARRAY_KERNELS_HPP)
+#error "c_array_algorithm.hpp includes c_array_kernels.hpp"
+#endif
+
+static_assert( std::is_trivially_copyable_v<lml::bounded_array<int>> );
+static_assert( lml::bounded_array_type<lml::bounded_array<int[2]> const&> );
+static_assert( ! lml::bounded_array_type<int[2]> );
+static_assert( std::is_convertible_v<lml::bounded_array<int>,
+                                     lml::bounded_array<int const>> );
+static_assert( ! std::is_convertible_v<lml::bounded_array<int const>,
+                                       lml::bounded_array<int>> );
+
+// bounded(a,n) of unbounded array; bounded(a) of C array
+extern int const u[];
+constexpr int u[] {1,2,3,4};
+static_assert( std::is_same_v<decltype(lml::bounded(u, 2)),
+                              lml::bounded_array<int const>> );
+static_assert( lml::bounded(u, 2).size() == 2 );
+constexpr int c23[2][3] {{1,2,3},{4,5,6}};
+static_assert( std::is_same_v<decltype(lml::bounded(c23)),
+                              lml::bounded_array<int const[3]>> );
+static_assert( lml::bounded(c23).flat_count() == 6
+            && lml::bounded(c23).flat(4) == 5
+            && lml::bounded(c23).size_bytes() == sizeof c23 );
+
+constexpr bool test_constexpr()
+{
+  int a[2][3] {}, b[3][3] {};
+  auto ba = lml::bounded(a);
+  lml::assign(ba) = c23;
+  bool ok = lml::equal_to{}(ba, lml::bounded(c23));
+  ok = ok && lml::compare_three_way{}(ba, lml::bounded(c23)) == 0;
+  ok = ok && lml::find(ba, 6) == 5;
+  lml::fill(lml::bounded(b), 1);
+  ok = ok && lml::bounded(b) < ba;
+  lml::assign(ba) = {};
+  return ok && a[1][2] == 0
+            && lml::hash{}(lml::bounded(c23)) == lml::hash{}(c23);
+}
+static_assert( test_constexpr() );
+
+// different extents: not equal, ordered by the common prefix then extent
+bool test_extents()
+{
+  int a[4] {1,2,3,4};
+  auto l = lml::bounded(a, 3), r = lml::bounded(a, 4);
+  assert( l != r && l < r && r > l );
+  assert( lml::bounded(a, 0) == lml::bounded(u, 0) );
+  a[2] = 4;
+  assert( l > lml::bounded(u, 4) );
+  return true;
+}
+
+// runtime paths, small and past kernel_min_bytes, agree with C arrays
+template <typename E, int N>
+bool test_runtime(E x, E y)
+{
+  E a[N], b[N];
+  lml::fill(lml::bounded(+a, N), x);
+  lml::assign(b) = a;
+  auto ba = lml::bounded(+a, N);
+  auto bb = lml::bounded(+b, N);
+  assert( ba == bb && lml::equal_to{}(ba, bb) );
+  assert( lml::hash{}(ba) == lml::hash{}(a) );
+  assert( lml::find(ba, y) == N );
+  b[N-1] = y;
+  assert( ba != bb && lml::find(bb, y) == N-1 );
+  assert( (ba <=> bb) == lml::compare_three_way{}(a, b) );
+  assert( (bb <=> ba) == lml::compare_three_way{}(b, a) );
+  assert( lml::hash{}(bb) == lml::hash{}(b) );
+  lml::assign(bb) = ba;
+  assert( lml::equal_to{}(a, b) );
+  return true;
+}
+
+// rows of an inner array type, as from a C API float (*)[3]
+bool test_rows()
+{
+  float m[40][3];
+  float (*p)[3] = m;
+  lml::fill(lml::bounded(p, 40), 0.5f);
+  assert( m[39][2] == 0.5f );
+  float n[40][3] {};
+  lml::assign(lml::bounded(n)) = lml::bounded(p, 40);
+  assert( lml::equal_to{}(m, n) );
+  assert( lml::hash{}(lml::bounded(p, 40)) == lml::hash{}(m) );
+  n[20][1] = -0.f;
+  m[20][1] = 0.f;
+  assert( lml::bounded(n) == lml::bounded(p, 40) );
+  assert( lml::hash{}(lml::bounded(n)) == lml::hash{}(m) );
+  lml::bounded_array<float const[3]> c = lml::bounded(p, 20);
+  assert( c.size() == 20 && &c[19][2] == &m[19][2] );
+  return true;
+}
+
+// ci a case-insensitive char, compared by its own == and <=>
+struct ci
+{
+  char c;
+  static constexpr char fold(char c) { return c | ('a' ^ 'A'); }
+  friend constexpr bool operator==(ci l, ci r) {
+    return fold(l.c) == fold(r.c); }
+  friend constexpr std::weak_ordering operator<=>(ci l, ci r) {
+    return fold(l.c) <=> fold(r.c); }
+};
+
+// class elements compare elementwise, never by bytes
+bool test_class_elements()
+{
+  ci u[70], v[70];
+  for (int i = 0; i != 70; ++i)
+    u[i] = {'q'}, v[i] = {'Q'};
+  assert( lml::bounded(u) == lml::bounded(v) );
+  assert( (lml::bounded(u) <=> lml::bounded(v)) == 0 );
+  u[69] = {'r'};
+  assert( lml::bounded(u) != lml::bounded(v) );
+  assert( (lml::bounded(u) <=> lml::bounded(v)) > 0 );
+  return true;
+}
+
+int main()
+{
+  test_extents();
+  test_runtime<char, 8>('a', 'b');
+  test_runtime<int, 3>(-1, 256);
+  test_runtime<int, 40>(-1, 256);
+  test_runtime<double, 20>(0.25, 0.5);
+  test_rows();
+  test_class_elements();
+}
@@ -2,7 +2,27 @@
 
 #include <cassert>
 
+// ci a case-insensitive char; class elements compare by their own ==,
+//  never by bytes, however small the array
+struct ci
+{
+  char c;
+  friend constexpr bool operator==(ci l, ci r) {
+    return (l.c | 0x20) == (r.c | 0x20); }
+};
+static_assert( ! lml::bytewise_comparable<ci[4], ci[4]> );
+
+bool test_class_elements()
+{
+  ci u[4]{{'a'},{'b'},{'c'},{'d'}}, v[4]{{'A'},{'B'},{'C'},{'D'}};
+  assert( lml::equal_to{}(u, v) );
+  v[3] = {'E'};
+  assert( ! lml::equal_to{}(u, v) );
+  return true;
+}
+
 int main() {
+  test_class_elements();
 
 //assert( lml::compare_three_way{}(a,     A{1,0}) < 0);
   //std::cout << std::endl;
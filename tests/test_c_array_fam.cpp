@@ -0,0 +1,66 @@
+#include "c_array_fam.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+struct msg_header { int type; short flags; };
+
+using msg = lml::fam<msg_header, double>;
+
+static_assert( msg::payload_offset == 8 );
+static_assert( msg::alignment == alignof(double) );
+static_assert( lml::fam<char, int>::payload_offset == alignof(int) );
+
+struct alignas(32) vec4 { float v[8]; };
+static_assert( lml::fam<msg_header, vec4>::payload_offset == 32 );
+static_assert( lml::fam<msg_header, vec4>::alignment == 32 );
+
+struct counted
+{
+  static inline int live = 0;
+  int v = 0;
+  counted() { ++live; }
+  ~counted() { --live; }
+};
+
+bool test_fam()
+{
+  auto m = msg::make(16, 2, short(1));
+  assert( m->type == 2 && m.header().flags == 1 );
+  assert( m.size() == 16 && m.payload().size() == 16 );
+  assert( m.size_bytes() == 8 + 16 * sizeof(double) );
+  assert( m.payload()[15] == 0.0 );   // value-initialized
+
+  double (&d)[4] = m.as<4>();
+  d[3] = 3.0;
+  assert( m.payload()[3] == 3.0 );
+  assert( reinterpret_cast<unsigned char*>(&d)
+       == reinterpret_cast<unsigned char*>(&m.header()) + 8 );
+
+  auto& z = m.as<0>();
+  static_assert( lml::flat_size<decltype(z)> == 0 );
+
+  auto v = lml::fam<msg_header, vec4>::make(3, 0, short(0));
+  assert( reinterpret_cast<std::uintptr_t>(&v.as<3>()) % 32 == 0 );
+
+  auto e = msg::make(0, 1, short(0));
+  assert( e.payload().empty() && e->type == 1 );
+
+  {
+    auto c = lml::fam<counted, counted[2]>::make(5);
+    assert( counted::live == 11 );
+    auto moved = std::move(c);
+    assert( ! c && moved && counted::live == 11 );
+    counted (&rows)[5][2] = moved.as<5>();
+    rows[4][1].v = 7;
+    assert( moved.payload()[4][1].v == 7 );
+  }
+  assert( counted::live == 0 );
+
+  return true;
+}
+
+int main()
+{
+  test_fam();
+}
@@ -0,0 +1,52 @@
+#include "c_array_fixed_string.hpp"
+
+#include <cassert>
+#include <string>
+
+template <lml::fixed_string name> struct metric
+{
+  static constexpr std::string_view key = name;
+};
+
+static_assert( std::is_same_v<metric<"requests">, metric<"requests">> );
+static_assert( ! std::is_same_v<metric<"requests">, metric<"request">> );
+static_assert( metric<"a.b">::key == "a.b" );
+
+constexpr lml::fixed_string key = "field";
+static_assert( std::is_same_v<decltype(key), lml::fixed_string<6> const> );
+static_assert( key.size() == 5 && ! key.empty() && key[4] == 'd' );
+static_assert( sizeof key == 8 && key.c_str()[5] == '\0' );
+
+static_assert( key == "field" && key != "fields" && key != "fiel" );
+static_assert( "field" == key );
+static_assert( key + ".id" == "field.id" && "x." + key == "x.field" );
+static_assert( (key + key).size() == 10 );
+
+// ordering: first differing char, in any word; then a prefix first
+static_assert( key < "fields" && key > "fiel" && key > "f" );
+static_assert( key < "fielz" && key > "fiela" );
+static_assert( (key <=> "field") == 0 );
+constexpr lml::fixed_string long_a = "0123456789abcdef0123456789abcdeX";
+constexpr lml::fixed_string long_b = "0123456789abcdef0123456789abcdeY";
+static_assert( long_a < long_b && long_b > long_a && long_a != long_b );
+static_assert( long_a < "0123456789abcdef0123456789abcdeX!" );
+static_assert( lml::fixed_string("") < "a" && lml::fixed_string("").empty() );
+
+// chars compare as char, as lml::compare_three_way of C arrays does
+constexpr char hi[] = "\x7f", lo[] = "\x80";
+static_assert( (lml::fixed_string(hi) <=> lo)
+            == lml::compare_three_way{}(hi, lo) );
+
+static_assert( lml::hashable<lml::fixed_string<40>> );
+static_assert( lml::hash{}(key) == lml::hash{}(lml::fixed_string("field")) );
+static_assert( lml::hash{}(key) != lml::hash{}(lml::fixed_string("fielD")) );
+
+int main()
+{
+  // runtime agrees with constant evaluation
+  lml::fixed_string<6> k = key;
+  assert( lml::hash{}(k) == lml::hash{}(key) );
+  assert( k == key && k < "fields" );
+  std::string s(k.begin(), k.end());
+  assert( s == "field" );
+}
@@ -0,0 +1,125 @@
+#include "c_array_half.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using lml::half_format;
+
+// known encodings, both ways
+static_assert( lml::impl::half_to_float(0x3c00) == 1.f
+            && lml::impl::half_to_float(0xc000) == -2.f
+            && lml::impl::half_to_float(0x7bff) == 65504.f
+            && lml::impl::half_to_float(0x0001) == 0x1p-24f
+            && lml::impl::half_to_float(0x03ff) == 0x3ffp-24f
+            && lml::impl::half_to_float(0x7c00)
+                            == std::numeric_limits<float>::infinity() );
+static_assert( lml::impl::float_to_half(1.f) == 0x3c00
+            && lml::impl::float_to_half(-0.f) == 0x8000
+            && lml::impl::float_to_half(65504.f) == 0x7bff
+            && lml::impl::float_to_half(65520.f) == 0x7c00   // rounds up
+            && lml::impl::float_to_half(65519.f) == 0x7bff
+            && lml::impl::float_to_half(0x1p-24f) == 0x0001
+            && lml::impl::float_to_half(0x1p-25f) == 0x0000  // tie to even
+            && lml::impl::float_to_half(0x1.8p-24f) == 0x0002
+            && lml::impl::float_to_half(1e-10f) == 0 );
+// ties to even: 1 + 2^-11 is halfway between 1 and 1 + 2^-10
+static_assert( lml::impl::float_to_half(1.f + 0x1p-11f) == 0x3c00
+            && lml::impl::float_to_half(1.f + 0x3p-11f) == 0x3c02 );
+static_assert( lml::impl::float_to_bfloat16(1.f) == 0x3f80
+            && lml::impl::float_to_bfloat16(1.f + 0x1p-8f) == 0x3f80
+            && lml::impl::float_to_bfloat16(1.f + 0x3p-8f) == 0x3f82
+            && lml::impl::bfloat16_to_float(0xc000) == -2.f );
+
+static_assert( lml::half_storage<std::uint16_t, half_format::bfloat16> );
+static_assert( ! lml::half_storage<std::int16_t, half_format::binary16> );
+#if defined(__FLT16_MANT_DIG__)
+static_assert( lml::half_storage<_Float16, half_format::binary16>
+            && ! lml::half_storage<_Float16, half_format::bfloat16> );
+#endif
+
+// same_extents checked by the type system
+template <typename D, typename S>
+concept convertible = requires (D& d, S const& s) { lml::convert(d, s); };
+static_assert( convertible<float[2][3], std::uint16_t[2][3]>
+            && convertible<std::uint16_t[6], float[6]> );
+static_assert( ! convertible<float[2][3], std::uint16_t[3][2]>
+            && ! convertible<float[6], std::uint16_t[2][3]>
+            && ! convertible<double[6], std::uint16_t[6]>
+            && ! convertible<float[6], float[6]>
+            && ! convertible<std::uint16_t const[6], float[6]> );
+
+constexpr bool test_constexpr()
+{
+  std::uint16_t h[2][2] {{0x3c00, 0xc000}, {0x0001, 0x7bff}};
+  float f[2][2];
+  lml::convert(f, h);
+  std::uint16_t r[2][2] {};
+  lml::convert(r, f);
+  return f[0][1] == -2.f && f[1][0] == 0x1p-24f
+      && r[0][0] == 0x3c00 && r[1][1] == 0x7bff;
+}
+static_assert( test_constexpr() );
+
+// every half round trips exactly, at every tier; narrowing agrees with
+// the portable path for floats on, between and beyond the halves
+template <half_format F>
+bool test_tiers()
+{
+  constexpr auto widen = F == half_format::binary16
+                       ? lml::impl::half_to_float
+                       : lml::impl::bfloat16_to_float;
+  constexpr auto narrow = F == half_format::binary16
+                        ? lml::impl::float_to_half
+                        : lml::impl::float_to_bfloat16;
+  static std::uint16_t h[65536 + 5], r[65536 + 5];
+  static float f[65536 + 5], g[65536 + 5];
+  for (std::uint32_t i = 0; i != 65536 + 5; ++i)
+    h[i] = static_cast<std::uint16_t>(i);
+  for (auto t : {lml::kernel_tier::scalar, lml::kernel_tier::sse2,
+                 lml::kernel_tier::avx2, lml::kernel_tier::avx512})
+  {
+    if (! lml::force_kernel_tier(t))
+      continue;
+    lml::convert<F>(f, h);
+    lml::convert<F>(r, f);
+    for (std::uint32_t i = 0; i != 65536; ++i) {
+      float x = widen(h[i]);
+      assert( std::bit_cast<std::uint32_t>(f[i])
+           == std::bit_cast<std::uint32_t>(x) );
+      assert( r[i] == h[i] || (std::isnan(x) && r[i] == (h[i] | (
+                         F == half_format::binary16 ? 0x200 : 0x40))) );
+    }
+    for (std::uint32_t i = 0; i != 65536 + 5; ++i)
+      g[i] = std::bit_cast<float>(i * 0x10001u ^ 0x5555u);
+    lml::convert<F>(r, g);
+    for (std::uint32_t i = 0; i != 65536 + 5; ++i)
+      assert( r[i] == narrow(g[i]) );
+  }
+  lml::force_kernel_tier(lml::impl::best_table()->tier);
+  return true;
+}
+
+#if defined(__FLT16_MANT_DIG__)
+bool test_float16()
+{
+  _Float16 h[20];
+  float f[20], g[20];
+  for (int i = 0; i != 20; ++i)
+    f[i] = 0.1f * float(i) - 1.f;
+  lml::convert(h, f);
+  lml::convert(g, h);
+  for (int i = 0; i != 20; ++i)
+    assert( g[i] == static_cast<float>(static_cast<_Float16>(f[i])) );
+  return true;
+}
+#endif
+
+int main()
+{
+  test_tiers<half_format::binary16>();
+  test_tiers<half_format::bfloat16>();
+#if defined(__FLT16_MANT_DIG__)
+  test_float16();
+#endif
+}
@@ -0,0 +1,54 @@
+#include "c_array_hash.hpp"
+
+#include <cassert>
+
+static_assert( lml::hashable<int> );
+static_assert( lml::hashable<int[2][3]> );
+static_assert( lml::hashable<char const(&)[6]> );
+static_assert( lml::hashable<double[4]> );
+static_assert( ! lml::hashable<long double[4]> );
+
+struct padded { char c; int i; };
+static_assert( ! lml::hashable<padded[2]> );
+
+constexpr char hello[] = "hello";
+static_assert( lml::hash{}(hello) == lml::hash{}("hello") );
+static_assert( lml::hash{}(hello) != lml::hash{}("world") );
+
+constexpr int a01_23[2][2] {{0,1},{2,3}};
+constexpr int a01_32[2][2] {{0,1},{3,2}};
+static_assert( lml::hash{}(a01_23) != lml::hash{}(a01_32) );
+
+constexpr double pz[2] {0.0, 1.0}, nz[2] {-0.0, 1.0};
+static_assert( lml::hash{}(pz) == lml::hash{}(nz) );
+
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+using int0 = int[0];
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+static_assert( lml::hashable<int0> );
+
+constexpr auto hello_hash = lml::hash{}(hello);
+constexpr auto a01_23_hash = lml::hash{}(a01_23);
+constexpr auto pz_hash = lml::hash{}(pz);
+
+int main()
+{
+  // runtime hash agrees with constant evaluated hash
+  char mhello[] = "hello";
+  int ma[2][2] {{0,1},{2,3}};
+  double mnz[2] {-0.0, 1.0};
+  assert( lml::hash{}(mhello) == hello_hash );
+  assert( lml::hash{}(ma) == a01_23_hash );
+  assert( lml::hash{}(mnz) == pz_hash );
+
+  // all byte tails hash distinctly
+  unsigned char bytes[17] {};
+  std::size_t h[17];
+  for (int n = 0; n != 17; ++n)
+    h[n] = lml::impl::hash_bytes(bytes, n);
+  for (int i = 0; i != 17; ++i)
+    for (int j = i + 1; j != 17; ++j)
+      assert( h[i] != h[j] );
+
+  assert( lml::hash{}(int0{}) == lml::impl::hash_bytes(nullptr, 0) );
+}
@@ -0,0 +1,55 @@
+#include "c_array_intern.hpp"
+
+#include <cassert>
+
+using symbols = lml::intern_pool<char[32], 4>;
+using digests = lml::intern_pool<unsigned char[20]>;
+
+static_assert( digests::chunk_size == 0x10000 / 20 );
+static_assert( std::is_trivially_copyable_v<symbols::id> );
+
+bool test_intern_pool()
+{
+  symbols pool;
+  char const alpha_[32] = "alpha", beta_[32] = "beta", gamma_[32] = "gamma";
+  auto a = pool.intern(alpha_);
+  auto b = pool.intern(beta_);
+  assert( a != b && a < b );
+  assert( pool.intern(alpha_) == a );
+  assert( pool.size() == 2 );
+  assert( lml::equal_to{}(pool[a], alpha_) && +pool[a] != +alpha_ );
+  assert( pool.find(beta_) == b );
+  assert( ! pool.find(gamma_) && ! pool.contains(gamma_) );
+
+  // interned references stay valid as chunks and table grow
+  char const* alpha = pool[a];
+  char key[32] {};
+  for (int i = 0; i != 1000; ++i)
+  {
+    key[0] = char('0' + i % 10);
+    key[1] = char('0' + i / 10 % 10);
+    key[2] = char('0' + i / 100);
+    auto k = pool.intern(key);
+    assert( lml::equal_to{}(pool[k], key) );
+  }
+  assert( pool.size() == 1002 );
+  assert( pool[a] == alpha && pool.intern(alpha_) == a );
+  key[0] = key[1] = key[2] = '5';
+  assert( pool.find(key)->value == 2 + 555 );
+
+  // a moved-from pool is empty and usable
+  symbols moved = std::move(pool);
+  assert( moved.size() == 1002 && moved.find(alpha_) == a );
+  assert( pool.size() == 0 && ! pool.contains(alpha_) );
+  assert( pool.intern(beta_).value == 0 && pool.find(beta_) );
+  pool = std::move(moved);
+  assert( pool.size() == 1002 && pool.find(beta_) == b );
+  assert( moved.size() == 0 && moved.intern(gamma_).value == 0 );
+
+  return true;
+}
+
+int main()
+{
+  test_intern_pool();
+}
@@ -0,0 +1,186 @@
+#include "c_array_kernels.hpp"
+#include "c_array_compare.hpp"
+#include "c_array_assign.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+using lml::kernel_tier;
+
+// the functors dispatch by kernel, header-only, with
+// LML_KERNELS_DISPATCH defined (or when the library is linked)
+static_assert( lml::impl::kernels_dispatched );
+
+static_assert( lml::bytewise_comparable<int[4][4], int const[4][4]> );
+static_assert( lml::bytewise_comparable<char(&)[64], char(&)[64]> );
+static_assert( ! lml::bytewise_comparable<int[4], int[5]> );
+static_assert( ! lml::bytewise_comparable<int[4], unsigned[4]> );
+static_assert( ! lml::bytewise_comparable<float[4], float[4]> );
+static_assert( ! lml::bytewise_comparable<int volatile[4], int[4]> );
+
+struct padded { char c; int i; };
+static_assert( ! lml::bytewise_comparable<padded[4], padded[4]> );
+
+// ci a case-insensitive char, with unique representations but its own
+//  == and <=>, so not bytewise comparable
+struct ci
+{
+  char c;
+  static constexpr char fold(char c) { return c | ('a' ^ 'A'); }
+  friend constexpr bool operator==(ci l, ci r) {
+    return fold(l.c) == fold(r.c); }
+  friend constexpr std::weak_ordering operator<=>(ci l, ci r) {
+    return fold(l.c) <=> fold(r.c); }
+};
+static_assert( std::has_unique_object_representations_v<ci> );
+static_assert( ! lml::bytewise_comparable<ci[70], ci[70]> );
+
+// the LML_KERNEL_TIER environment variable caps the first resolution
+bool test_env_cap()
+{
+  setenv("LML_KERNEL_TIER", "scalar", 1);
+  assert( lml::active_kernel_tier() == kernel_tier::scalar );
+  assert( lml::kernel_tier_supported(kernel_tier::scalar) );
+  return true;
+}
+
+std::size_t naive_mismatch(unsigned char const* a, unsigned char const* b,
+                           std::size_t n)
+{
+  std::size_t i = 0;
+  while (i != n && a[i] == b[i])
+    ++i;
+  return i;
+}
+
+// every supported tier agrees with the naive loop, at every length,
+// alignment and mismatch position
+bool test_mismatch(kernel_tier t)
+{
+  if (! lml::force_kernel_tier(t))
+    return true;
+  assert( lml::active_kernel_tier() == t );
+
+  static unsigned char a[512], b[512];
+  for (std::size_t i = 0; i != sizeof a; ++i)
+    a[i] = b[i] = static_cast<unsigned char>(i * 7);
+
+  auto mismatch = lml::kernels().mismatch;
+  for (std::size_t off = 0; off != 3; ++off)
+    for (std::size_t n = 0; n != 200; ++n)
+    {
+      assert( mismatch(a + off, b + off, n) == n );
+      for (std::size_t d : {std::size_t{0}, n / 2, n - 1})
+        if (d < n)
+        {
+          b[off + d] ^= 0x80;
+          assert( mismatch(a + off, b + off, n) == d );
+          assert( naive_mismatch(a + off, b + off, n) == d );
+          b[off + d] ^= 0x80;
+        }
+    }
+
+  unsigned char c[300];
+  lml::kernels().copy(c, a + 1, sizeof c);
+  assert( std::memcmp(c, a + 1, sizeof c) == 0 );
+  return true;
+}
+
+// the functors agree with elementwise results on kernel-sized arrays
+bool test_functors(kernel_tier t)
+{
+  if (! lml::force_kernel_tier(t))
+    return true;
+
+  int a[8][16]{}, b[8][16]{};
+  static_assert( lml::impl::kernel_comparable<int(&)[8][16], int(&)[8][16]> );
+
+  assert( lml::equal_to{}(a, b) );
+  assert( ! lml::less{}(a, b) );
+  assert( lml::compare_three_way{}(a, b) == 0 );
+
+  b[5][3] = -1;
+  a[6][0] = 100;  // after the first difference, so ignored
+  assert( ! lml::equal_to{}(a, b) );
+  assert( lml::less{}(b, a) );
+  assert( ! lml::less{}(a, b) );
+  assert( lml::compare_three_way{}(a, b) > 0 );
+  assert( lml::compare_three_way{}(b, a) < 0 );
+
+  b[0][0] = 1;  // first element
+  assert( lml::less{}(a, b) );
+
+  char s[128]{}, u[128]{};
+  u[127] = 1;   // last element
+  assert( lml::compare_three_way{}(s, u) < 0 );
+  assert( ! lml::equal_to{}(s, u) );
+
+  lml::assign(s) = u;
+  assert( lml::equal_to{}(s, u) );
+  return true;
+}
+
+// class elements compare by their own operators at runtime, as in
+//  constant evaluation, not by bytes
+constexpr bool test_class_elements()
+{
+  ci x[70], y[70];
+  for (int i = 0; i != 70; ++i)
+    x[i] = {'a'}, y[i] = {'A'};
+  bool ok = lml::equal_to{}(x, y) && lml::compare_three_way{}(x, y) == 0
+         && ! lml::less{}(x, y) && ! lml::less{}(y, x);
+  x[10] = {'b'};
+  return ok && ! lml::equal_to{}(x, y)
+            && lml::compare_three_way{}(x, y) > 0
+            && lml::less{}(y, x) && ! lml::less{}(x, y);
+}
+static_assert( test_class_elements() );
+
+// arrays of the same byte size share the canonical kernels
+template <std::size_t B>
+bool test_canonical()
+{
+  unsigned char a[B + 1], b[B + 1];
+  for (std::size_t i = 0; i != B + 1; ++i)
+    a[i] = static_cast<unsigned char>(i), b[i] = 0;
+  lml::impl::copy_bytes_n<B>(b, a);
+  assert( std::memcmp(a, b, B) == 0 && b[B] == 0 );
+  assert( lml::impl::equal_bytes_n<B>(a, b) );
+  if constexpr (B != 0) {
+    b[B - 1] ^= 1;
+    assert( ! lml::impl::equal_bytes_n<B>(a, b) );
+  }
+  return true;
+}
+
+bool test_shapes()
+{
+  test_canonical<0>();
+  test_canonical<24>();
+  test_canonical<lml::kernel_min_bytes>();
+  test_canonical<200>();
+
+  int a[2][3] {{1,2,3},{4,5,6}}, b[2][3]{};
+  unsigned u[6] {1,2,3,4,5,6}, v[6]{};
+  lml::assign(b) = a;
+  lml::assign(v) = u;
+  assert( lml::equal_to{}(a, b) && lml::equal_to{}(u, v) );
+  v[5] = 0;
+  assert( ! lml::equal_to{}(u, v) );
+  return true;
+}
+
+int main()
+{
+  test_env_cap();
+  test_shapes();
+  for (auto t : {kernel_tier::scalar, kernel_tier::sse2, kernel_tier::avx2,
+                 kernel_tier::avx512, kernel_tier::neon})
+  {
+    test_mismatch(t);
+    test_functors(t);
+    if (lml::force_kernel_tier(t))
+      assert( test_class_elements() );
+  }
+}
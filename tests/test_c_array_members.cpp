@@ -0,0 +1,111 @@
+#include "c_array_members.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+struct packed { int id; char tag[12]; std::int32_t n[2][2]; };
+struct padded { char c; int i[3]; short s; };
+struct mixed { int id; char tag[4]; std::string name; double w[2]; int k; };
+struct empty {};
+
+static_assert( lml::member_count_v<packed> == 3 );
+static_assert( lml::member_count_v<padded> == 3 );
+static_assert( lml::member_count_v<mixed> == 5 );
+static_assert( lml::member_count_v<empty> == 0 );
+static_assert( lml::member_aggregate<packed const&> );
+static_assert( ! lml::member_aggregate<int[2]> );
+static_assert( ! lml::member_aggregate<std::string> );
+
+static_assert( std::is_same_v<lml::impl::member_compare_t<packed>,
+                              std::strong_ordering> );
+static_assert( std::is_same_v<lml::impl::member_compare_t<mixed>,
+                              std::partial_ordering> );
+
+static_assert( lml::impl::bytewise_comparable_member<int[4]> );
+static_assert( ! lml::impl::bytewise_comparable_member<float[4]> );
+static_assert( ! lml::impl::bytewise_member<std::string[2]> );
+
+constexpr bool test_constexpr()
+{
+  packed a{1, "tag", {{1,2},{3,4}}}, b{};
+  lml::assign_members(b, a);
+  bool ok = lml::compare_members(a, b) == 0;
+  b.n[1][0] = 5;
+  return ok && lml::compare_members(a, b) < 0
+            && lml::compare_members(b, a) > 0;
+}
+static_assert( test_constexpr() );
+
+// a member that differs after an equal, coalesced run is found
+bool test_packed()
+{
+  packed a{7, "abc", {{1,2},{3,4}}}, b{};
+  lml::assign_members(b, a);
+  assert( b.id == 7 && b.tag[2] == 'c' && b.n[1][1] == 4 );
+  assert( lml::compare_members(a, b) == 0 );
+  b.n[0][1] = 1;
+  assert( lml::compare_members(a, b) > 0 );
+  b.n[0][1] = 2;
+  b.tag[3] = 'd';
+  assert( lml::compare_members(a, b) < 0 );
+  b.id = 6;                       // earlier member decides
+  assert( lml::compare_members(a, b) > 0 );
+  return true;
+}
+
+// members compare as values, not bytes; negative ints, any endianness
+bool test_order()
+{
+  packed a{-1, "", {}}, b{1, "", {}};
+  assert( lml::compare_members(a, b) < 0 );
+  a.id = 1;
+  a.n[0][0] = 256;
+  b.n[0][0] = 1;
+  assert( lml::compare_members(a, b) > 0 );
+  return true;
+}
+
+bool test_padded()
+{
+  padded a{'x', {1,2,3}, 4}, b{};
+  lml::assign_members(b, a);
+  assert( b.c == 'x' && b.i[2] == 3 && b.s == 4 );
+  assert( lml::compare_members(a, b) == 0 );
+  b.s = 5;
+  assert( lml::compare_members(a, b) < 0 );
+  return true;
+}
+
+bool test_mixed()
+{
+  mixed a{1, "ab", "a string too long for the small buffer", {0.5, 1.5}, 9};
+  mixed b{};
+  lml::assign_members(b, a);
+  assert( b.id == 1 && b.tag[1] == 'b' && b.name == a.name
+       && b.w[1] == 1.5 && b.k == 9 );
+  assert( lml::compare_members(a, b) == 0 );
+  b.name[0] = 'b';
+  assert( lml::compare_members(a, b) < 0 );
+  b.name = a.name;
+  b.w[0] = 0.0/0.0;
+  assert( lml::compare_members(a, b) == std::partial_ordering::unordered );
+  b.w[0] = 0.5;
+  b.k = 8;
+  assert( lml::compare_members(a, b) > 0 );
+  lml::assign_members(b, b);
+  assert( b.k == 8 && b.name == a.name );
+  return true;
+}
+
+int main()
+{
+  test_packed();
+  test_order();
+  test_padded();
+  test_mixed();
+
+  empty e, f;
+  lml::assign_members(e, f);
+  assert( lml::compare_members(e, f) == 0 );
+}
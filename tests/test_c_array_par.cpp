@@ -0,0 +1,204 @@
+#include "c_array_par.hpp"
+#include "c_array_compare.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using lml::par::thread_pool;
+
+// each index is visited exactly once, in chunks of at least grain
+bool test_thread_pool()
+{
+  thread_pool pool{3};
+  assert( pool.concurrency() == 4 );
+
+  std::vector<std::atomic<int>> hits(100000);
+  std::atomic<std::size_t> short_chunks{0};
+  pool.for_range(hits.size(), 100, [&](std::size_t b, std::size_t e) {
+    assert( thread_pool::in_pool() );
+    if (e - b < 50)
+      ++short_chunks;
+    for (; b != e; ++b)
+      ++hits[b];
+  });
+  for (auto& h : hits)
+    assert( h == 1 );
+  assert( short_chunks == 0 );
+  assert( ! thread_pool::in_pool() );
+
+  // nested loops run serially in the calling thread
+  std::atomic<int> nested{0};
+  pool.for_range(64, 1, [&](std::size_t b, std::size_t e) {
+    pool.for_range(e - b, 1, [&](std::size_t x, std::size_t y) {
+      assert( x == 0 && y == e - b );
+      nested += int(y);
+    });
+  });
+  assert( nested == 64 );
+
+  // max_threads == 1 is serial, a single call
+  int calls = 0;
+  pool.for_range(1000, 1, [&](std::size_t, std::size_t) { ++calls; }, 1);
+  assert( calls == 1 );
+
+  // exceptions propagate to the caller, and the pool remains usable
+  bool caught = false;
+  try {
+    pool.for_range(1000, 1, [](std::size_t b, std::size_t) {
+      if (b == 500)
+        throw std::runtime_error("500");
+    });
+  }
+  catch (std::runtime_error const&) { caught = true; }
+  assert( caught );
+
+  std::atomic<std::size_t> sum{0};
+  for (int loop = 0; loop != 100; ++loop)
+    pool.for_range(1000, 10, [&](std::size_t b, std::size_t e) {
+      sum += e - b;
+    });
+  assert( sum == 100 * 1000 );
+
+  return true;
+}
+
+static unsigned big[512][1024];
+static unsigned other[512][1024];
+
+bool test_par_for_each()
+{
+  unsigned n = 0;
+  for (auto& row : other)
+    for (auto& v : row)
+      v = n++;
+
+  lml::par::for_each(big, [](unsigned& v) { v = 1; });
+  lml::par::for_each_zip(big, other, [](unsigned& l, unsigned r) {
+    l += r;
+  });
+  for (unsigned i = 0; i != n; ++i)
+    assert( lml::flat_index(big, i) == i + 1 );
+
+  lml::par::for_each_row(big, [](unsigned (&row)[1024]) {
+    row[0] = 0;
+  });
+  for (auto& row : big)
+    assert( row[0] == 0 );
+
+  std::atomic<unsigned long long> sum{0};
+  lml::par::for_each(std::as_const(other), [&](unsigned const& v) {
+    sum += v;
+  });
+  assert( sum == (unsigned long long)n * (n - 1) / 2 );
+
+  // small arrays are processed serially, in order
+  int small[3][4]{};
+  int i = 0;
+  lml::par::for_each(small, [&](int& v) { v = i++; });
+  assert( small[2][3] == 11 );
+
+  return true;
+}
+
+static unsigned copy[512][1024];
+
+struct text { std::string s = "default, too long for short strings"; };
+static text texts[64][1024];
+static text texts_copy[64][1024];
+
+bool test_par_assign()
+{
+  lml::par::assign(copy) = other;
+  assert( lml::equal_to{}(copy, other) );
+
+  lml::assign(copy) = {};
+  lml::par::assign(copy, 1) = other;
+  assert( copy[511][1023] == other[511][1023] );
+
+  lml::assign(copy) = {};
+  lml::par::stream_assign(copy) = other;
+  assert( lml::equal_to{}(copy, other) );
+
+  // rvalue and braced-init sources
+  lml::par::assign(copy[0]) = {1u, 2u, 3u};
+  assert( copy[0][2] == 3 && copy[0][3] == 0 );
+
+  // non bulk copyable elements are assigned elementwise
+  texts[63][1023].s = "last";
+  lml::par::assign(texts_copy) = texts;
+  assert( texts_copy[63][1023].s == "last" && texts_copy[0][0].s[0] == 'd' );
+
+  // non-temporal copy, at all alignments of source and destination
+  unsigned char src[300], dst[300];
+  for (int i = 0; i != 300; ++i)
+    src[i] = (unsigned char)i;
+  for (int d = 0; d != 17; ++d)
+    for (int s = 0; s != 17; ++s)
+      for (std::size_t n : {0, 1, 15, 16, 63, 64, 65, 200}) {
+        lml::assign(dst) = {};
+        lml::par::impl::stream_copy(dst + d, src + s, n);
+        for (std::size_t i = 0; i != n; ++i)
+          assert( dst[d + i] == src[s + i] );
+        assert( dst[d + n] == 0 );
+      }
+
+  return true;
+}
+
+static float lhs[256][1024];
+static float rhs[256][1024];
+
+// results agree with the serial functors, for any mismatch positions
+bool test_par_compare()
+{
+  lml::par::equal_to eq;
+  lml::par::compare_three_way cmp;
+
+  assert( eq(lhs, rhs) && cmp(lhs, rhs) == 0 );
+
+  std::size_t const n = lml::flat_size<decltype(lhs)>;
+  for (std::size_t i : {std::size_t{0}, std::size_t{1}, std::size_t{1023},
+                        n / 3, n / 2, n - 1})
+  {
+    lml::flat_index(rhs, i) = 1.f;
+    lml::flat_index(lhs, n - 1 - i) = 2.f;
+    assert( eq(lhs, rhs) == lml::equal_to{}(lhs, rhs) );
+    assert( cmp(lhs, rhs) == lml::compare_three_way{}(lhs, rhs) );
+    assert( cmp(rhs, lhs) == lml::compare_three_way{}(rhs, lhs) );
+    lml::flat_index(rhs, i) = 0.f;
+    lml::flat_index(lhs, n - 1 - i) = 0.f;
+  }
+  assert( eq(lhs, rhs) );
+
+  // unordered NaN is a mismatch, as for the serial functor
+  lml::flat_index(lhs, n / 2) = std::numeric_limits<float>::quiet_NaN();
+  lml::flat_index(rhs, n - 1) = 1.f;
+  assert( cmp(lhs, rhs) == std::partial_ordering::unordered );
+  assert( ! eq(lhs, lhs) );
+  lml::flat_index(lhs, n / 2) = 0.f;
+
+  // small and braced-init operands
+  int a[2][2]{{1,2},{3,4}};
+  assert( eq(a, {{1,2},{3,4}}) );
+  assert( cmp(a, {{1,2},{3,5}}) < 0 );
+
+  return true;
+}
+
+static_assert( lml::par::impl::page_stride<char[3]> == 4096 );
+static_assert( lml::par::impl::line_stride<char> == 64 );
+static_assert( lml::par::impl::line_stride<double> == 8 );
+static_assert( lml::par::impl::line_stride<char[12]> == 16 );
+
+int main()
+{
+  test_thread_pool();
+  test_par_for_each();
+  test_par_assign();
+  test_par_compare();
+}
@@ -0,0 +1,130 @@
+#include "c_array_par_sort.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+
+using lml::par::thread_pool;
+
+static_assert( lml::par::impl::batcher_network<8>().size() == 19 );
+static_assert( lml::par::impl::batcher_network<16>().size() == 63 );
+static_assert( lml::par::impl::batcher_network<1>().size() == 0 );
+
+// networks sort all 0-1 inputs, so sort all inputs (0-1 principle)
+template <std::size_t N>
+bool test_network()
+{
+  for (unsigned bits = 0; bits != 1u << N; ++bits)
+  {
+    int a[N];
+    for (std::size_t i = 0; i != N; ++i)
+      a[i] = bits >> i & 1;
+    lml::par::sort(a);
+    assert( std::is_sorted(a, a + N) );
+  }
+  return true;
+}
+
+template <std::size_t... N>
+bool test_networks(std::index_sequence<N...>)
+{
+  return (test_network<N + 1>() && ...);
+}
+
+static std::uint64_t keys[1 << 18];
+static std::uint64_t expect[1 << 18];
+
+bool test_par_sort()
+{
+  test_networks(std::make_index_sequence<lml::par::network_max>{});
+
+  int m[2][3]{{5,4,3},{2,1,0}};
+  lml::par::sort(m);
+  assert( lml::equal_to{}(m, {{0,1,2},{3,4,5}}) );
+  lml::par::sort(m, std::greater{});
+  assert( m[0][0] == 5 && m[1][2] == 0 );
+
+  std::mt19937_64 gen{42};
+  for (auto& k : keys)
+    k = gen() % 1000;  // with duplicates
+  std::memcpy(expect, keys, sizeof keys);
+  std::sort(expect, expect + std::size(expect));
+
+  lml::par::sort(keys);
+  assert( lml::equal_to{}(keys, expect) );
+
+  // the parallel merge, on a local pool, for various sizes
+  thread_pool pool{3};
+  for (std::size_t n : {std::size_t{1} << 18, std::size_t{100003},
+                        std::size_t{65536 * 3 + 1}})
+  {
+    std::shuffle(keys, keys + n, gen);
+    std::memcpy(expect, keys, n * sizeof *keys);
+    std::sort(expect, expect + n);
+    lml::par::impl::merge_sort<false>(pool, keys, n, std::less{});
+    assert( std::equal(keys, keys + n, expect) );
+  }
+
+  // leaf sorts: network blocks, a short tail, merges within the run
+  static std::uint64_t buf[4099];
+  static std::string strs[4099], sbuf[4099];
+  for (std::size_t n : {0, 1, 15, 16, 17, 33, 1000, 4099})
+  {
+    std::shuffle(keys, keys + n, gen);
+    std::memcpy(expect, keys, n * sizeof *keys);
+    std::sort(expect, expect + n);
+    lml::par::impl::leaf_sort(keys, n, buf, std::less{});
+    assert( std::equal(keys, keys + n, expect) );
+
+    for (std::size_t i = 0; i != n; ++i)
+      strs[i] = std::to_string(gen() % 500);
+    lml::par::impl::leaf_sort(strs, n, sbuf, std::less{});
+    assert( std::is_sorted(strs, strs + n) );
+  }
+
+  // stable merges
+  std::pair<int,int> kv[1 << 16];
+  for (int i = 0; i != 1 << 16; ++i)
+    kv[i] = {int(gen() % 7), i};
+  lml::par::impl::merge_sort<true>(pool, kv, 1 << 16,
+    [](auto const& l, auto const& r) { return l.first < r.first; });
+  assert( std::is_sorted(kv, kv + (1 << 16)) );
+
+  return true;
+}
+
+static char names[1 << 15][16];
+static int rows[1 << 15][2];
+
+bool test_par_sort_rows()
+{
+  std::mt19937 gen{7};
+  for (auto& name : names)
+    for (int i = 0; i != 15; ++i)
+      name[i] = char('a' + gen() % 4);
+  lml::par::sort_rows(names);
+  for (std::size_t i = 1; i != std::size(names); ++i)
+    assert( ! lml::less{}(names[i], names[i - 1]) );
+
+  // stable: equal keys keep their order
+  for (int i = 0; i != 1 << 15; ++i)
+    lml::assign(rows[i]) = {int(gen() % 5), i};
+  lml::par::sort_rows(rows, [](int const(&l)[2], int const(&r)[2]) {
+    return l[0] < r[0];
+  });
+  for (std::size_t i = 1; i != std::size(rows); ++i)
+    assert( rows[i - 1][0] < rows[i][0]
+         || (rows[i - 1][0] == rows[i][0] && rows[i - 1][1] < rows[i][1]) );
+
+  return true;
+}
+
+int main()
+{
+  test_par_sort();
+  test_par_sort_rows();
+}
@@ -0,0 +1,105 @@
+#include "c_array_simd.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(LML_SIMD_STDX) || defined(LML_SIMD_VECTOR_EXT)
+
+#if defined(LML_SIMD_VECTOR_EXT)
+// Wide vector returns change the ABI without AVX enabled, as in the header;
+// not popped, as the instantiations are emitted at the end of the file
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+static_assert( lml::simd_array<float[8]> );
+static_assert( lml::simd_array<int const(&)[2][4]> );
+static_assert( ! lml::simd_array<bool[8]> );
+static_assert( ! lml::simd_array<int*[8]> );
+struct xy { float x, y; };
+static_assert( ! lml::simd_array<xy[4]> );
+
+template <typename V>
+auto lane(V const& v, std::size_t i) { return lml::impl::lane_t<V>(v[i]); }
+
+// whole arrays round trip through simd values, multidim as-if flat
+bool test_load_store()
+{
+  float a[8]{1, 2, 3, 4, 5, 6, 7, 8}, b[8]{};
+  auto v = lml::simd_load(a);
+  assert( lane(v, 0) == 1 && lane(v, 7) == 8 );
+  lml::simd_store(b, v * 2);
+  for (int i = 0; i != 8; ++i)
+    assert( b[i] == a[i] * 2 );
+
+  int const m[3][3]{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+  int n[3][3]{};
+  lml::simd_store(n, lml::simd_load(m) + 1);
+  assert( n[0][0] == 2 && n[1][2] == 7 && n[2][2] == 10 );
+
+  std::uint8_t bytes[5]{250, 251, 252, 253, 254};
+  lml::simd_store(bytes, lml::simd_load(bytes) + 1);
+  assert( bytes[0] == 251 && bytes[4] == 255 );
+  return true;
+}
+
+// a view covers every element once, in full chunks and a masked tail
+template <typename T, std::size_t N>
+bool test_view()
+{
+  static T x[N];
+  for (std::size_t i = 0; i != N; ++i)
+    x[i] = T(i % 100);
+
+  auto view = lml::simd_view(x);
+  constexpr auto width = decltype(view)::width;
+  static_assert( decltype(view)::size() == (N + width - 1) / width );
+
+  std::size_t seen = 0, chunks = 0;
+  for (auto c : view)
+  {
+    assert( c.data() == x + seen );
+    assert( c.full() || c.size() == N % width );
+    auto v = c.load();
+    auto mask = c.mask();
+    for (std::size_t i = 0; i != width; ++i)
+    {
+      assert( bool(mask[i]) == (i < c.size()) );
+      if (i >= c.size())
+        assert( lane(v, i) == T{} );
+    }
+    c.store(v + v);
+    seen += c.size();
+    ++chunks;
+  }
+  assert( seen == N && chunks == view.size() );
+  for (std::size_t i = 0; i != N; ++i)
+    assert( x[i] == T(2 * (i % 100)) );
+
+  T const (&cx)[N] = x;
+  T sum{};
+  for (auto c : lml::simd_view(cx))
+  {
+    auto v = c.load();
+    for (std::size_t i = 0; i != c.size(); ++i)
+      sum += lane(v, i);
+  }
+  T expect{};
+  for (auto e : x)
+    expect += e;
+  assert( sum == expect );
+  return true;
+}
+
+#endif
+
+int main()
+{
+#if defined(LML_SIMD_STDX) || defined(LML_SIMD_VECTOR_EXT)
+  test_load_store();
+  test_view<float, 37>();
+  test_view<double, 64>();
+  test_view<std::int16_t, 3>();
+  test_view<std::uint8_t, 100>();
+  test_view<int, 1>();
+#endif
+}
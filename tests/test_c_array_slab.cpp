@@ -0,0 +1,82 @@
+#include "c_array_slab.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using floats = lml::array_slab<float[64]>;
+using bytes = lml::array_slab<unsigned char[3], 4>;
+
+static_assert( floats::slot_size == 256 && floats::slab_slots == 256 );
+static_assert( bytes::slot_size == 64 && bytes::slab_slots == 1024 );
+
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+using int0 = int[0];
+#include "ALLOW_ZERO_SIZE_ARRAY.hpp"
+static_assert( lml::array_slab<int0>::slot_size == 0 );
+
+struct counted
+{
+  static inline int live = 0;
+  counted() { ++live; }
+  ~counted() { --live; }
+};
+
+bool test_array_slab()
+{
+  float (&a)[64] = floats::allocate();
+  float (&b)[64] = floats::allocate();
+  assert( &a != &b );
+  assert( reinterpret_cast<std::uintptr_t>(&a) % 64 == 0 );
+  a[63] = 1.f;
+  b[0] = 2.f;
+  floats::deallocate(a);
+  float (&c)[64] = floats::allocate();
+  assert( &c == &a );  // LIFO reuse
+  floats::deallocate(b);
+  floats::deallocate(c);
+
+  // elements are constructed and destroyed
+  auto& d = lml::array_slab<counted[2][3]>::allocate();
+  assert( counted::live == 6 );
+  lml::array_slab<counted[2][3]>::deallocate(d);
+  assert( counted::live == 0 );
+
+  // zero-size arrays share a single object
+  assert( &lml::array_slab<int0>::allocate()
+       == &lml::array_slab<int0>::allocate() );
+
+  return true;
+}
+
+// slots freed on other threads, and on thread exit, are reused
+bool test_array_slab_threads()
+{
+  std::vector<unsigned char(*)[3]> slots(1000);
+  std::thread([&] {
+    for (auto& s : slots) {
+      s = &bytes::allocate();
+      (*s)[0] = 1;
+    }
+  }).join();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t)
+    threads.emplace_back([&, t] {
+      for (int i = t; i < 1000; i += 4)
+        bytes::deallocate(*slots[i]);
+      for (int i = 0; i != 500; ++i)
+        bytes::deallocate(bytes::allocate());
+    });
+  for (auto& t : threads)
+    t.join();
+
+  return true;
+}
+
+int main()
+{
+  test_array_slab();
+  test_array_slab_threads();
+}
@@ -0,0 +1,85 @@
+#include "c_array_tracked.hpp"
+
+#include <cassert>
+#include <cstring>
+
+using tracked = lml::tracked_array<int[4][64]>;
+
+static_assert( tracked::chunk_size == 16 );
+static_assert( tracked::chunk_count == 16 );
+
+bool test_dirty_bits()
+{
+  lml::dirty_bits d(200);
+  d.set_range(60, 130);
+  d.set(199);
+  d.set(0);
+  assert( d.count() == 72 && d.test(63) && d.test(64) && ! d.test(130) );
+
+  std::size_t runs[3][2], n = 0;
+  d.for_each_run([&](std::size_t f, std::size_t l) {
+    runs[n][0] = f; runs[n][1] = l; ++n;
+  });
+  assert( n == 3 );
+  assert( runs[0][0] == 0 && runs[0][1] == 1 );
+  assert( runs[1][0] == 60 && runs[1][1] == 130 );
+  assert( runs[2][0] == 199 && runs[2][1] == 200 );
+
+  lml::dirty_bits e(128);
+  e.set_all();
+  n = 0;
+  e.for_each_run([&](std::size_t f, std::size_t l) {
+    assert( f == 0 && l == 128 ); ++n;
+  });
+  assert( n == 1 );
+
+  return true;
+}
+
+bool test_tracked_array()
+{
+  int a[4][64] {};
+  int copy[4][64] {};
+  tracked t{a};
+  assert( ! t.modified() );
+
+  t.set(5, 1);
+  t.write(6) = 2;
+  t.write(17) = 3;               // adjacent chunk, coalesces
+  t.assign_row(2, {7,7,7});      // chunks 8-11
+  t.assign(250, {9,9,9});        // last chunk
+  int const(&r)[4][64] = t;
+  assert( &r == &a && r[0][5] == 1 && r[2][1] == 7 && t[252] == 9 );
+  assert( t.is_dirty(0) && t.is_dirty(1) && ! t.is_dirty(2) );
+
+  std::size_t offsets[4], sizes[4], n = 0;
+  t.flush([&](std::size_t offset, unsigned char const* p, std::size_t s) {
+    offsets[n] = offset; sizes[n++] = s;
+    std::memcpy(reinterpret_cast<unsigned char*>(&copy) + offset, p, s);
+  });
+  assert( n == 3 );
+  assert( offsets[0] == 0 && sizes[0] == 128 );
+  assert( offsets[1] == 512 && sizes[1] == 256 );
+  assert( offsets[2] == 960 && sizes[2] == 64 );
+  assert( std::memcmp(copy, a, sizeof a) == 0 );
+  assert( ! t.modified() );
+
+  t.assign(copy);
+  n = 0;
+  t.flush([&](std::size_t offset, unsigned char const*, std::size_t s) {
+    assert( offset == 0 && s == sizeof a ); ++n;
+  });
+  assert( n == 1 );
+
+  t.writable()[3][63] = 4;
+  t.mark_dirty(255, 1);
+  assert( t.is_dirty(15) && ! t.is_dirty(14) );
+
+  return true;
+}
+
+int main()
+{
+  test_dirty_bits();
+  test_tracked_array();
+}